@@ -0,0 +1,136 @@
+// Standard headers
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Internal headers
+#include "timer.h"
+
+// Main header
+#include "bench.h"
+
+// Macros
+#define NUMBER_SAMPLES 15
+#define MIN_SAMPLE_TIME 20000000ULL // nanoseconds
+
+/*----------------------------------------------------------------------------*/
+/*                             ALLOCATION COUNTING                            */
+/*----------------------------------------------------------------------------*/
+
+// The benchmarks are linked with --wrap for each of these functions,
+// so every allocation made by the game goes through the wrappers
+static size_t number_allocations = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t number, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+
+void* __wrap_malloc(size_t size) {
+  number_allocations++;
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t number, size_t size) {
+  number_allocations++;
+  return __real_calloc(number, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+  number_allocations++;
+  return __real_realloc(pointer, size);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+uint64_t time_benchmark_sample(benchmark_t benchmark,
+                               void* state,
+                               size_t iterations);
+size_t calibrate_benchmark_iterations(benchmark_t benchmark, void* state);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+benchmark_result_t run_benchmark(benchmark_t benchmark) {
+  void* state = benchmark.setup != NULL ? benchmark.setup() : NULL;
+
+  // Calibration also warms up caches and branch predictors
+  size_t iterations = calibrate_benchmark_iterations(benchmark, state);
+
+  double sample_times[NUMBER_SAMPLES];
+  size_t initial_allocations = number_allocations;
+
+  for (size_t s = 0; s < NUMBER_SAMPLES; s++) {
+    uint64_t elapsed_time
+      = time_benchmark_sample(benchmark, state, iterations);
+    sample_times[s] = (double) elapsed_time / iterations;
+  }
+
+  size_t allocations = number_allocations - initial_allocations;
+
+  if (benchmark.teardown != NULL) benchmark.teardown(state);
+
+  double mean_time = 0;
+  for (size_t s = 0; s < NUMBER_SAMPLES; s++) {
+    mean_time += sample_times[s] / NUMBER_SAMPLES;
+  }
+
+  double time_variance = 0;
+  for (size_t s = 0; s < NUMBER_SAMPLES; s++) {
+    double deviation = sample_times[s] - mean_time;
+    time_variance += deviation * deviation / (NUMBER_SAMPLES - 1);
+  }
+
+  return (benchmark_result_t) {
+    .name = benchmark.name,
+    .samples = NUMBER_SAMPLES,
+    .iterations = iterations,
+    .mean_time = mean_time,
+    .time_variance = time_variance,
+    .allocations = (double) allocations / (NUMBER_SAMPLES * iterations),
+  };
+}
+
+/*----------------------------------------------------------------------------*/
+
+void print_benchmark_result(benchmark_result_t result) {
+  double deviation = sqrt(result.time_variance);
+
+  printf("%-34s %14.1f ns/op  var %12.1f (+- %5.2f%%)  "
+      "%9.2f allocs/op  [%lu x %lu]\n",
+      result.name, result.mean_time, result.time_variance,
+      result.mean_time > 0 ? 100.0 * deviation / result.mean_time : 0.0,
+      result.allocations, result.samples, result.iterations);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+uint64_t time_benchmark_sample(benchmark_t benchmark,
+                               void* state,
+                               size_t iterations) {
+  uint64_t start_time = get_monotonic_time();
+  benchmark.run(state, iterations);
+  return get_monotonic_time() - start_time;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Doubles the iterations until a sample takes at least MIN_SAMPLE_TIME,
+// so timer resolution and overhead do not matter
+size_t calibrate_benchmark_iterations(benchmark_t benchmark, void* state) {
+  size_t iterations = 1;
+
+  while (time_benchmark_sample(benchmark, state, iterations)
+         < MIN_SAMPLE_TIME) {
+    iterations *= 2;
+  }
+
+  return iterations;
+}
+
+/*----------------------------------------------------------------------------*/
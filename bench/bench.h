@@ -0,0 +1,39 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Standard headers
+#include <stddef.h>
+
+// Structs
+
+/**
+ * A benchmark runs an operation many times on a state prepared by
+ * setup(), which is timed in samples of the same number of iterations.
+ */
+struct benchmark {
+  const char* name;
+  void* (*setup)(void);
+  void (*run)(void* state, size_t iterations);
+  void (*teardown)(void* state);
+};
+typedef struct benchmark benchmark_t;
+
+/**
+ * Time per operation across samples, and memory allocations
+ * (malloc, calloc and realloc) per operation.
+ */
+struct benchmark_result {
+  const char* name;
+  size_t samples;
+  size_t iterations;
+  double mean_time;
+  double time_variance;
+  double allocations;
+};
+typedef struct benchmark_result benchmark_result_t;
+
+// Functions
+benchmark_result_t run_benchmark(benchmark_t benchmark);
+void print_benchmark_result(benchmark_result_t result);
+
+#endif // BENCH_H
@@ -0,0 +1,823 @@
+// Standard headers
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Internal headers
+#include "attacker.h"
+#include "defender.h"
+#include "distance_field.h"
+#include "field.h"
+#include "game.h"
+#include "item.h"
+#include "map.h"
+#include "mcts_attacker.h"
+#include "random.h"
+#include "renderer.h"
+#include "spy.h"
+#include "team_game.h"
+
+// Main header
+#include "bench.h"
+
+// Macros
+#define BENCH_SEED 42
+#define BENCH_FIELD_DIMENSION (dimension_t) { 10, 10 }
+#define BENCH_RENDER_DIMENSION (dimension_t) { 200, 200 }
+#define BENCH_GRID_DIMENSION (dimension_t) { 4096, 4096 }
+#define BENCH_DISTANCE_DIMENSION (dimension_t) { 2048, 2048 }
+#define BENCH_MAX_NUMBER_SPIES 1LU
+#define BENCH_MAX_TURNS 42
+#define BENCH_TEAM_DIMENSION (dimension_t) { 200, 1000 }
+#define BENCH_TEAM_SIZE 50
+#define BENCH_TEAM_MAX_TURNS 2000
+
+/*----------------------------------------------------------------------------*/
+/*                             AUXILIARY STRUCTS                              */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * A field with a single item, which is moved back and forth.
+ */
+struct field_state {
+  Field field;
+  Item item;
+};
+typedef struct field_state field_state_t;
+
+/**
+ * A large field with a single moving item, drawn to /dev/null.
+ */
+struct render_state {
+  Field field;
+  Item item;
+  Renderer renderer;
+  int null_file;
+};
+typedef struct render_state render_state_t;
+
+/**
+ * A large field or distance field in a given layout, whose cells are
+ * read around a player walking across it. The checksum keeps the reads
+ * alive.
+ */
+struct grid_state {
+  Field field;
+  DistanceField distance_field;
+  position_t walker;
+  rng_t rng;
+  size_t checksum;
+};
+typedef struct grid_state grid_state_t;
+
+/**
+ * A strategy context with a fixed seed and a spy on the opponent.
+ */
+struct strategy_state {
+  void* context;
+  Item opponent;
+  Spy opponent_spy;
+};
+typedef struct strategy_state strategy_state_t;
+
+/*----------------------------------------------------------------------------*/
+/*                       AUXILIARY FUNCTIONS DECLARATION                      */
+/*----------------------------------------------------------------------------*/
+
+void* setup_field(void);
+void teardown_field(void* state);
+void run_move_item_in_field(void* state, size_t iterations);
+
+void* setup_render(RenderMode mode);
+void* setup_full_render(void);
+void* setup_diff_render(void);
+void teardown_render(void* state);
+void run_render_field(void* state, size_t iterations);
+void run_render_field_grid(void* state, size_t iterations);
+
+void* setup_row_major_field_grid(void);
+void* setup_tiled_field_grid(void);
+void* setup_row_major_distance_grid(void);
+void* setup_tiled_distance_grid(void);
+void teardown_grid(void* state);
+position_t walk_across_grid(grid_state_t* state);
+void run_field_neighborhood(void* state, size_t iterations);
+void run_distance_neighborhood(void* state, size_t iterations);
+void run_new_row_major_distance_field(void* state, size_t iterations);
+void run_new_tiled_distance_field(void* state, size_t iterations);
+
+void* setup_attacker_strategy(void);
+void* setup_defender_strategy(void);
+void teardown_attacker_strategy(void* state);
+void teardown_defender_strategy(void* state);
+void run_attacker_strategy(void* state, size_t iterations);
+void run_defender_strategy(void* state, size_t iterations);
+
+void* setup_mcts_attacker_strategy(void);
+void teardown_mcts_attacker_strategy(void* state);
+void run_mcts_attacker_strategy(void* state, size_t iterations);
+
+Map make_bench_map(size_t size);
+void* setup_small_map(void);
+void* setup_medium_map(void);
+void* setup_large_map(void);
+void teardown_map(void* state);
+void run_new_game_from_map(void* state, size_t iterations);
+
+void run_play_game(void* state, size_t iterations);
+
+void run_play_team_game(void* state, size_t iterations);
+
+void* setup_game_pool(void);
+void teardown_game_pool(void* state);
+void run_play_pooled_game(void* state, size_t iterations);
+void run_play_pooled_generic_game(void* state, size_t iterations);
+
+void* setup_game(void);
+void teardown_game(void* state);
+void run_make_unmake_game_move(void* state, size_t iterations);
+void run_snapshot_restore_game(void* state, size_t iterations);
+void run_clone_game(void* state, size_t iterations);
+
+/*----------------------------------------------------------------------------*/
+/*                               MAIN FUNCTION                                */
+/*----------------------------------------------------------------------------*/
+
+int main() {
+  benchmark_t benchmarks[] = {
+    {
+      "move_item_in_field",
+      setup_field, run_move_item_in_field, teardown_field,
+    },
+    {
+      "field walk (4096x4096)",
+      setup_row_major_field_grid, run_field_neighborhood, teardown_grid,
+    },
+    {
+      "field walk (4096x4096, tiled)",
+      setup_tiled_field_grid, run_field_neighborhood, teardown_grid,
+    },
+    {
+      "distance walk (4096x4096)",
+      setup_row_major_distance_grid, run_distance_neighborhood, teardown_grid,
+    },
+    {
+      "distance walk (4096x4096, tiled)",
+      setup_tiled_distance_grid, run_distance_neighborhood, teardown_grid,
+    },
+    {
+      "distance_field (2048x2048)",
+      NULL, run_new_row_major_distance_field, NULL,
+    },
+    {
+      "distance_field (2048x2048, tiled)",
+      NULL, run_new_tiled_distance_field, NULL,
+    },
+    {
+      "execute_attacker_strategy",
+      setup_attacker_strategy, run_attacker_strategy,
+      teardown_attacker_strategy,
+    },
+    {
+      "execute_defender_strategy",
+      setup_defender_strategy, run_defender_strategy,
+      teardown_defender_strategy,
+    },
+    {
+      "mcts_attacker (1000 rollouts)",
+      setup_mcts_attacker_strategy, run_mcts_attacker_strategy,
+      teardown_mcts_attacker_strategy,
+    },
+    {
+      "new_game_from_map (10x10)",
+      setup_small_map, run_new_game_from_map, teardown_map,
+    },
+    {
+      "new_game_from_map (100x100)",
+      setup_medium_map, run_new_game_from_map, teardown_map,
+    },
+    {
+      "new_game_from_map (1000x1000)",
+      setup_large_map, run_new_game_from_map, teardown_map,
+    },
+    {
+      "render_field (200x200, full)",
+      setup_full_render, run_render_field, teardown_render,
+    },
+    {
+      "render_field_grid (200x200)",
+      setup_full_render, run_render_field_grid, teardown_render,
+    },
+    {
+      "render_field (200x200, diff)",
+      setup_diff_render, run_render_field, teardown_render,
+    },
+    {
+      "play_game",
+      NULL, run_play_game, NULL,
+    },
+    {
+      "play_team_game (50 vs 50)",
+      NULL, run_play_team_game, NULL,
+    },
+    {
+      "play_game (pooled)",
+      setup_game_pool, run_play_pooled_game, teardown_game_pool,
+    },
+    {
+      "play_game (pooled, generic loop)",
+      setup_game_pool, run_play_pooled_generic_game, teardown_game_pool,
+    },
+    {
+      "make_game_move/unmake_game_move",
+      setup_game, run_make_unmake_game_move, teardown_game,
+    },
+    {
+      "snapshot_game/restore_game",
+      setup_game, run_snapshot_restore_game, teardown_game,
+    },
+    {
+      "clone_game",
+      setup_game, run_clone_game, teardown_game,
+    },
+  };
+
+  size_t number_benchmarks = sizeof(benchmarks) / sizeof(*benchmarks);
+  for (size_t b = 0; b < number_benchmarks; b++) {
+    benchmark_result_t result = run_benchmark(benchmarks[b]);
+    print_benchmark_result(result);
+    fflush(stdout);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             AUXILIARY FUNCTIONS                            */
+/*----------------------------------------------------------------------------*/
+
+void* setup_field(void) {
+  field_state_t* state = malloc(sizeof(*state));
+
+  state->field = new_field(BENCH_FIELD_DIMENSION);
+  state->item = new_item('A', true);
+
+  add_item_to_field(state->field, state->item, (position_t) { 5, 5 });
+
+  return state;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void teardown_field(void* state) {
+  field_state_t* field_state = state;
+
+  delete_item(field_state->item);
+  delete_field(field_state->field);
+  free(field_state);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void run_move_item_in_field(void* state, size_t iterations) {
+  field_state_t* field_state = state;
+
+  direction_t directions[] = { DIR_RIGHT, DIR_LEFT };
+  for (size_t k = 0; k < iterations; k++) {
+    move_item_in_field(field_state->field, field_state->item,
+                       directions[k % 2]);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_render(RenderMode mode) {
+  render_state_t* state = malloc(sizeof(*state));
+
+  state->field = new_field(BENCH_RENDER_DIMENSION);
+  state->item = new_item('A', true);
+  state->null_file = open("/dev/null", O_WRONLY);
+  state->renderer
+    = new_renderer(BENCH_RENDER_DIMENSION, mode, state->null_file);
+
+  add_item_to_field(state->field, state->item, (position_t) { 100, 100 });
+
+  return state;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_full_render(void) {
+  return setup_render(RENDER_FULL);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_diff_render(void) {
+  return setup_render(RENDER_DIFF);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void teardown_render(void* state) {
+  render_state_t* render_state = state;
+
+  delete_renderer(render_state->renderer);
+  close(render_state->null_file);
+  delete_item(render_state->item);
+  delete_field(render_state->field);
+  free(render_state);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Each frame follows a move, as in a game
+void run_render_field(void* state, size_t iterations) {
+  render_state_t* render_state = state;
+
+  direction_t directions[] = { DIR_RIGHT, DIR_LEFT };
+  for (size_t k = 0; k < iterations; k++) {
+    move_item_in_field(render_state->field, render_state->item,
+                       directions[k % 2]);
+    render_field(render_state->renderer, render_state->field, k);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void run_render_field_grid(void* state, size_t iterations) {
+  render_state_t* render_state = state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    render_field_grid(render_state->renderer, render_state->field);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_row_major_field_grid(void) {
+  grid_state_t* state = calloc(1, sizeof(*state));
+  state->field
+    = new_field_with_layout(BENCH_GRID_DIMENSION, LAYOUT_ROW_MAJOR);
+  state->rng = new_rng(BENCH_SEED);
+  return state;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_tiled_field_grid(void) {
+  grid_state_t* state = calloc(1, sizeof(*state));
+  state->field = new_field_with_layout(BENCH_GRID_DIMENSION, LAYOUT_TILED);
+  state->rng = new_rng(BENCH_SEED);
+  return state;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_row_major_distance_grid(void) {
+  grid_state_t* state = calloc(1, sizeof(*state));
+  state->distance_field = new_bordered_distance_field_with_layout(
+      BENCH_GRID_DIMENSION, LAYOUT_ROW_MAJOR);
+  state->rng = new_rng(BENCH_SEED);
+  return state;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_tiled_distance_grid(void) {
+  grid_state_t* state = calloc(1, sizeof(*state));
+  state->distance_field = new_bordered_distance_field_with_layout(
+      BENCH_GRID_DIMENSION, LAYOUT_TILED);
+  state->rng = new_rng(BENCH_SEED);
+  return state;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void teardown_grid(void* state) {
+  grid_state_t* grid_state = state;
+
+  delete_field(grid_state->field);
+  delete_distance_field(grid_state->distance_field);
+  free(grid_state);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The walker goes down and right, as the attacker does on its way to
+// the goal, and starts again from a random row of the first column
+// when it reaches the borders, so the grid is always cold in the cache
+position_t walk_across_grid(grid_state_t* state) {
+  dimension_t dimension = BENCH_GRID_DIMENSION;
+  position_t* walker = &state->walker;
+
+  walker->i++;
+  walker->j++;
+  if (walker->i >= dimension.height-1 || walker->j >= dimension.width-1) {
+    walker->i = 1 + next_rng(&state->rng) % (dimension.height - 2);
+    walker->j = 1;
+  }
+
+  return *walker;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Each operation reads a cell and its 8 neighbors, as the strategies
+// do; row-major grids load a new cache line for every step of the walk
+void run_field_neighborhood(void* state, size_t iterations) {
+  grid_state_t* grid_state = state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    position_t center = walk_across_grid(grid_state);
+
+    for (size_t i = center.i-1; i <= center.i+1; i++) {
+      for (size_t j = center.j-1; j <= center.j+1; j++) {
+        Item item = get_field_item(grid_state->field, (position_t) { i, j });
+        grid_state->checksum += item == NULL;
+      }
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void run_distance_neighborhood(void* state, size_t iterations) {
+  grid_state_t* grid_state = state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    position_t center = walk_across_grid(grid_state);
+
+    for (size_t i = center.i-1; i <= center.i+1; i++) {
+      for (size_t j = center.j-1; j <= center.j+1; j++) {
+        grid_state->checksum += get_goal_distance(
+            grid_state->distance_field, (position_t) { i, j });
+      }
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The search visits the cells in waves parallel to the goal column,
+// which are a whole row apart from each other in row-major grids
+void run_new_row_major_distance_field(void* state, size_t iterations) {
+  (void) state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    delete_distance_field(new_bordered_distance_field_with_layout(
+          BENCH_DISTANCE_DIMENSION, LAYOUT_ROW_MAJOR));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void run_new_tiled_distance_field(void* state, size_t iterations) {
+  (void) state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    delete_distance_field(new_bordered_distance_field_with_layout(
+          BENCH_DISTANCE_DIMENSION, LAYOUT_TILED));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_attacker_strategy(void) {
+  strategy_state_t* state = malloc(sizeof(*state));
+
+  state->context = new_attacker_context(NULL);
+  reset_attacker_context(state->context, BENCH_SEED);
+
+  state->opponent = new_item('D', true);
+  set_item_position(state->opponent, (position_t) { 5, 8 });
+  state->opponent_spy = new_spy(state->opponent);
+
+  return state;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_defender_strategy(void) {
+  strategy_state_t* state = malloc(sizeof(*state));
+
+  state->context = new_defender_context(NULL);
+  reset_defender_context(state->context, BENCH_SEED);
+
+  state->opponent = new_item('A', true);
+  set_item_position(state->opponent, (position_t) { 5, 1 });
+  state->opponent_spy = new_spy(state->opponent);
+
+  return state;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void teardown_attacker_strategy(void* state) {
+  strategy_state_t* strategy_state = state;
+
+  delete_spy(strategy_state->opponent_spy);
+  delete_item(strategy_state->opponent);
+  delete_attacker_context(strategy_state->context);
+  free(strategy_state);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void teardown_defender_strategy(void* state) {
+  strategy_state_t* strategy_state = state;
+
+  delete_spy(strategy_state->opponent_spy);
+  delete_item(strategy_state->opponent);
+  delete_defender_context(strategy_state->context);
+  free(strategy_state);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The direction is accumulated so the calls cannot be optimized away
+void run_attacker_strategy(void* state, size_t iterations) {
+  strategy_state_t* strategy_state = state;
+
+  volatile int sink = 0;
+  for (size_t k = 0; k < iterations; k++) {
+    direction_t direction = execute_attacker_strategy_in_context(
+        strategy_state->context, (position_t) { 5, 1 },
+        strategy_state->opponent_spy);
+    sink += direction.i + direction.j;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_mcts_attacker_strategy(void) {
+  strategy_state_t* state = malloc(sizeof(*state));
+
+  mcts_parameters_t parameters = DEFAULT_MCTS_PARAMETERS;
+  state->context = new_mcts_attacker_context(&parameters);
+  reset_mcts_attacker_context(state->context, BENCH_SEED);
+
+  state->opponent = new_item('D', true);
+  set_item_position(state->opponent, (position_t) { 5, 8 });
+  state->opponent_spy = new_spy(state->opponent);
+
+  return state;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void teardown_mcts_attacker_strategy(void* state) {
+  strategy_state_t* strategy_state = state;
+
+  delete_spy(strategy_state->opponent_spy);
+  delete_item(strategy_state->opponent);
+  delete_mcts_attacker_context(strategy_state->context);
+  free(strategy_state);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void run_mcts_attacker_strategy(void* state, size_t iterations) {
+  strategy_state_t* strategy_state = state;
+
+  volatile int sink = 0;
+  for (size_t k = 0; k < iterations; k++) {
+    direction_t direction = execute_mcts_attacker_strategy(
+        strategy_state->context, (position_t) { 5, 1 },
+        strategy_state->opponent_spy);
+    sink += direction.i + direction.j;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void run_defender_strategy(void* state, size_t iterations) {
+  strategy_state_t* strategy_state = state;
+
+  volatile int sink = 0;
+  for (size_t k = 0; k < iterations; k++) {
+    direction_t direction = execute_defender_strategy_in_context(
+        strategy_state->context, (position_t) { 5, 8 },
+        strategy_state->opponent_spy);
+    sink += direction.i + direction.j;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Writes a square map with borders and both players to a temporary
+// file, which is removed once the map is loaded
+Map make_bench_map(size_t size) {
+  char map_path[] = "/tmp/rugby-bench-XXXXXX";
+  int map_file = mkstemp(map_path);
+  if (map_file < 0) return NULL;
+
+  FILE* map_stream = fdopen(map_file, "w");
+  fprintf(map_stream, "%lu,%lu\n", size, size);
+
+  for (size_t i = 0; i < size; i++) {
+    for (size_t j = 0; j < size; j++) {
+      bool is_border = i == 0 || j == 0 || i == size-1 || j == size-1;
+
+      char symbol = is_border ? 'X' : '.';
+      if (i == size/2 && j == 1) symbol = 'A';
+      if (i == size/2 && j == size-2) symbol = 'D';
+
+      putc(symbol, map_stream);
+    }
+    putc('\n', map_stream);
+  }
+
+  fclose(map_stream);
+
+  Map map = new_map(map_path);
+  unlink(map_path);
+
+  return map;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_small_map(void) {
+  return make_bench_map(10);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_medium_map(void) {
+  return make_bench_map(100);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_large_map(void) {
+  return make_bench_map(1000);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void teardown_map(void* state) {
+  delete_map(state);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void run_new_game_from_map(void* state, size_t iterations) {
+  for (size_t k = 0; k < iterations; k++) {
+    Game game = new_game_from_map(
+        state,
+        BENCH_MAX_NUMBER_SPIES,
+        execute_attacker_strategy,
+        execute_defender_strategy);
+    delete_game(game);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Each operation is a whole game, from its creation to its deletion
+void run_play_game(void* state, size_t iterations) {
+  (void) state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    Game game = new_contextual_game(
+        BENCH_FIELD_DIMENSION,
+        BENCH_MAX_NUMBER_SPIES,
+        (contextual_strategy_t) ATTACKER_CONTEXTUAL_STRATEGY,
+        (contextual_strategy_t) DEFENDER_CONTEXTUAL_STRATEGY);
+
+    seed_game(game, BENCH_SEED + k);
+    play_game_quietly(game, BENCH_MAX_TURNS);
+    delete_game(game);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Games are long enough for the attackers to cross the field
+void run_play_team_game(void* state, size_t iterations) {
+  (void) state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    TeamGame game = new_team_game(
+        BENCH_TEAM_DIMENSION,
+        BENCH_TEAM_SIZE,
+        BENCH_TEAM_SIZE,
+        BENCH_MAX_NUMBER_SPIES,
+        (contextual_strategy_t) ATTACKER_CONTEXTUAL_STRATEGY,
+        (contextual_strategy_t) DEFENDER_CONTEXTUAL_STRATEGY);
+
+    seed_team_game(game, BENCH_SEED + k);
+    play_team_game_quietly(game, BENCH_TEAM_MAX_TURNS);
+    delete_team_game(game);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_game_pool(void) {
+  return new_game_pool(
+      NULL,
+      BENCH_FIELD_DIMENSION,
+      BENCH_MAX_NUMBER_SPIES,
+      (contextual_strategy_t) ATTACKER_CONTEXTUAL_STRATEGY,
+      (contextual_strategy_t) DEFENDER_CONTEXTUAL_STRATEGY);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void teardown_game_pool(void* state) {
+  delete_game_pool(state);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The same games as run_play_game(), reusing a pooled game
+void run_play_pooled_game(void* state, size_t iterations) {
+  GamePool pool = state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    Game game = acquire_pooled_game(pool);
+
+    seed_game(game, BENCH_SEED + k);
+    play_game_quietly(game, BENCH_MAX_TURNS);
+    release_pooled_game(pool, game);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The same games as run_play_pooled_game(), with an observer that does
+// nothing, which keeps them out of the specialized play loop
+void run_play_pooled_generic_game(void* state, size_t iterations) {
+  GamePool pool = state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    Game game = acquire_pooled_game(pool);
+
+    add_game_observer(game, (game_observer_t) { .data = NULL });
+    seed_game(game, BENCH_SEED + k);
+    play_game_quietly(game, BENCH_MAX_TURNS);
+    remove_game_observers(game);
+    release_pooled_game(pool, game);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* setup_game(void) {
+  Game game = new_contextual_game(
+      BENCH_FIELD_DIMENSION,
+      BENCH_MAX_NUMBER_SPIES,
+      (contextual_strategy_t) ATTACKER_CONTEXTUAL_STRATEGY,
+      (contextual_strategy_t) DEFENDER_CONTEXTUAL_STRATEGY);
+
+  seed_game(game, BENCH_SEED);
+
+  return game;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void teardown_game(void* state) {
+  delete_game(state);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Each operation is a move of both players, which is then reverted
+void run_make_unmake_game_move(void* state, size_t iterations) {
+  Game game = state;
+  direction_t attacker_direction = DIR_RIGHT;
+  direction_t defender_direction = DIR_LEFT;
+
+  for (size_t k = 0; k < iterations; k++) {
+    game_undo_t undo
+      = make_game_move(game, attacker_direction, defender_direction);
+    unmake_game_move(game, undo);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void run_snapshot_restore_game(void* state, size_t iterations) {
+  Game game = state;
+
+  for (size_t k = 0; k < iterations; k++) {
+    game_snapshot_t snapshot = snapshot_game(game);
+    restore_game(game, snapshot);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void run_clone_game(void* state, size_t iterations) {
+  for (size_t k = 0; k < iterations; k++) {
+    delete_game(clone_game(state));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
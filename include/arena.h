@@ -0,0 +1,37 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+// Standard headers
+#include <stddef.h>
+
+// Structs
+
+/**
+ * An arena gives memory by bumping a pointer in large blocks, which are
+ * only freed all at once, when the arena is deleted. Objects created in
+ * an arena must not be deleted by themselves. Requests larger than the
+ * block size get a block of their own.
+ */
+typedef struct arena* Arena;
+
+// Macros
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+// Functions
+Arena new_arena(size_t block_size);
+void delete_arena(Arena arena);
+
+/**
+ * Returns memory aligned for any type, which is not initialized.
+ */
+void* allocate_from_arena(Arena arena, size_t size);
+
+/**
+ * Forgets all allocations but keeps the blocks, to be reused.
+ */
+void clear_arena(Arena arena);
+
+size_t get_arena_used_size(Arena arena);
+size_t get_arena_reserved_size(Arena arena);
+
+#endif // ARENA_H
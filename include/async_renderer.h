@@ -0,0 +1,55 @@
+#ifndef ASYNC_RENDERER_H
+#define ASYNC_RENDERER_H
+
+// Standard headers
+#include <stdbool.h>
+#include <stddef.h>
+
+// Internal headers
+#include "field.h"
+#include "item.h"
+#include "renderer.h"
+
+// Structs
+
+/**
+ * An asynchronous renderer draws the frames of a Game in its own thread,
+ * so the game does not wait for the terminal. Every turn, the game pushes
+ * the positions of the movable items into a single-producer single-
+ * consumer ring, and the render thread moves their symbols in its own
+ * copy of the grid before drawing it with a Renderer.
+ * When dropping frames, a full ring makes the game skip the frame instead
+ * of waiting, and the render thread draws only the latest frame it has.
+ * The last frame is always drawn.
+ */
+typedef struct async_renderer* AsyncRenderer;
+
+// Macros
+#define ASYNC_RENDERER_MAX_ITEMS 4
+#define ASYNC_RENDERER_CAPACITY 1024 // Frames, must be a power of two
+
+// Functions
+
+/**
+ * Starts the render thread with the current grid of the field, where
+ * the given items (at most ASYNC_RENDERER_MAX_ITEMS) will move.
+ * Returns NULL if the render thread or its buffers cannot be created.
+ */
+AsyncRenderer new_async_renderer(Field field,
+                                 const Item* items,
+                                 size_t number_items,
+                                 RenderMode mode,
+                                 int file_descriptor,
+                                 bool is_dropping_frames);
+
+/**
+ * Pushes the last frame, waits until the render thread draws it
+ * and stops the thread.
+ */
+void delete_async_renderer(AsyncRenderer async_renderer);
+
+void push_async_frame(AsyncRenderer async_renderer, size_t turn);
+
+size_t get_async_renderer_dropped_frames(AsyncRenderer async_renderer);
+
+#endif // ASYNC_RENDERER_H
@@ -1,10 +1,27 @@
 #ifndef ATTACKER_H
 #define ATTACKER_H
 
+// Standard headers
+#include <stdint.h>
+
 // Internal headers
 #include "position.h"
 #include "spy.h"
 
+// Macros
+
+/**
+ * The Attacker strategy with an explicit context, to be given
+ * to new_contextual_game() as a contextual_strategy_t.
+ */
+#define ATTACKER_CONTEXTUAL_STRATEGY { \
+  new_attacker_context, \
+  reset_attacker_context, \
+  delete_attacker_context, \
+  execute_attacker_strategy_in_context, \
+  NULL, \
+}
+
 // Functions
 
 /**
@@ -15,4 +32,18 @@
 direction_t execute_attacker_strategy(position_t attacker_position,
                                       Spy defender_spy);
 
+/**
+ * Same as execute_attacker_strategy(), but keeping its state in a context
+ * created by new_attacker_context() instead of static variables.
+ * Each context should be used by a single game at a time.
+ * Resetting a context restarts its random numbers from the given seed.
+ */
+void* new_attacker_context(const void* parameters);
+void reset_attacker_context(void* attacker_context, uint64_t seed);
+void delete_attacker_context(void* attacker_context);
+
+direction_t execute_attacker_strategy_in_context(void* attacker_context,
+                                                 position_t attacker_position,
+                                                 Spy defender_spy);
+
 #endif // ATTACKER_H
@@ -0,0 +1,48 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+// Standard headers
+#include <stddef.h>
+
+// Internal headers
+#include "game.h"
+#include "histogram.h"
+#include "tournament.h"
+
+// Structs
+
+/**
+ * A batch plays many games of a tournament in lockstep. The state of
+ * all games is kept in structure-of-arrays form (one array per player
+ * coordinate, spy uses, status...) and every turn is played for all
+ * games at once: first the strategies decide the directions, then
+ * branch-free loops move the players against a shared obstacle bitmap
+ * and detect which games are over.
+ */
+typedef struct batch* Batch;
+
+// Functions
+
+/**
+ * Creates a batch with number_lanes games of the tournament, whose
+ * strategies must have a context. Returns NULL if its map is invalid.
+ */
+Batch new_batch(tournament_t tournament, size_t number_lanes);
+void delete_batch(Batch batch);
+
+size_t get_batch_number_lanes(Batch batch);
+void set_batch_latency_histograms(Batch batch,
+                                  Histogram attacker_latencies,
+                                  Histogram defender_latencies);
+
+/**
+ * Plays the games first_game, first_game+1, ... of the tournament,
+ * one per lane, and stores their results. Games are seeded as in
+ * play_tournament(), so their results are the same.
+ */
+void play_batch(Batch batch,
+                size_t first_game,
+                size_t number_games,
+                game_result_t* results);
+
+#endif // BATCH_H
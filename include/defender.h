@@ -1,10 +1,27 @@
 #ifndef DEFENDER_H
 #define DEFENDER_H
 
+// Standard headers
+#include <stdint.h>
+
 // Internal headers
 #include "position.h"
 #include "spy.h"
 
+// Macros
+
+/**
+ * The Defender strategy with an explicit context, to be given
+ * to new_contextual_game() as a contextual_strategy_t.
+ */
+#define DEFENDER_CONTEXTUAL_STRATEGY { \
+  new_defender_context, \
+  reset_defender_context, \
+  delete_defender_context, \
+  execute_defender_strategy_in_context, \
+  NULL, \
+}
+
 // Functions
 
 /**
@@ -15,4 +32,18 @@
 direction_t execute_defender_strategy(position_t defender_position,
                                       Spy attacker_spy);
 
+/**
+ * Same as execute_defender_strategy(), but keeping its state in a context
+ * created by new_defender_context() instead of static variables.
+ * Each context should be used by a single game at a time.
+ * Resetting a context restarts its random numbers from the given seed.
+ */
+void* new_defender_context(const void* parameters);
+void reset_defender_context(void* defender_context, uint64_t seed);
+void delete_defender_context(void* defender_context);
+
+direction_t execute_defender_strategy_in_context(void* defender_context,
+                                                 position_t defender_position,
+                                                 Spy attacker_spy);
+
 #endif // DEFENDER_H
@@ -0,0 +1,55 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+// Standard headers
+#include <stdint.h>
+
+// Internal headers
+#include "dimension.h"
+#include "layout.h"
+#include "map.h"
+#include "position.h"
+
+// Structs
+
+/**
+ * A distance field has, for every cell of a field, the least number of
+ * moves (in any of the 8 directions) the attacker needs to reach the goal
+ * column, going around the obstacles. It is computed once, by a breadth-
+ * first search from the goal, and never changes afterwards, so it can be
+ * shared by all games and strategies played in the same field, even in
+ * different threads. Players are not obstacles, as they move.
+ */
+typedef struct distance_field* DistanceField;
+
+// Macros
+#define UNREACHABLE_DISTANCE UINT32_MAX
+
+// Functions
+
+/**
+ * Distance field of the map, or of a standard field of the given
+ * dimension, whose only obstacles are its borders. Distances of large
+ * fields are tiled, unless they are created with another layout.
+ * Returns NULL if the distances cannot be allocated.
+ */
+DistanceField new_distance_field(Map map);
+DistanceField new_bordered_distance_field(dimension_t dimension);
+DistanceField new_bordered_distance_field_with_layout(dimension_t dimension,
+                                                      GridLayout layout);
+void delete_distance_field(DistanceField distance_field);
+
+dimension_t get_distance_field_dimension(DistanceField distance_field);
+
+/**
+ * Distance from a cell to the goal column, or UNREACHABLE_DISTANCE if the
+ * cell is an obstacle, is out of the field or cannot reach the goal.
+ */
+uint32_t get_goal_distance(DistanceField distance_field, position_t position);
+
+/**
+ * Largest distance of a cell that can reach the goal column.
+ */
+uint32_t get_max_goal_distance(DistanceField distance_field);
+
+#endif // DISTANCE_FIELD_H
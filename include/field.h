@@ -3,9 +3,12 @@
 
 // Standard headers
 #include <stdbool.h>
+#include <stddef.h>
 
 // Internal headers
+#include "arena.h"
 #include "dimension.h"
+#include "layout.h"
 #include "position.h"
 #include "item.h"
 
@@ -18,17 +21,79 @@ typedef struct field* Field;
 
 // Macros
 #define FIELD_MIN_DIMENSION (dimension_t) { 3, 3 }
+#define FIELD_MAX_ITEMS 255 // Distinct items, each may be in many positions
 
 // Functions
 Field new_field(dimension_t dimension);
+
+/**
+ * Fields are tiled when they are large, unless they are created with
+ * another layout. Small and huge fields are not stored in a grid and
+ * ignore the layout.
+ */
+Field new_field_with_layout(dimension_t dimension, GridLayout layout);
+Field new_field_in_arena(Arena arena, dimension_t dimension);
 void delete_field(Field field);
 
 dimension_t get_field_dimension(Field field);
 
 void print_field_info(Field field);
-void print_field_grid(Field field);
+
+/**
+ * Writes the grid of the field, as renderers draw it, into a buffer with
+ * room for get_field_grid_length() characters, and returns how many it
+ * wrote.
+ * Row i starts at i * (2 * width + 2), and the symbol of the cell (i, j)
+ * is 2 * j + 1 characters after it.
+ */
+size_t get_field_grid_length(Field field);
+size_t write_field_grid(Field field, char* buffer);
+
+/**
+ * Item in the cell, or NULL if it is empty or beyond the field.
+ */
+Item get_field_item(Field field, position_t position);
 
 void add_item_to_field(Field field, Item item, position_t position);
 void move_item_in_field(Field field, Item item, direction_t direction);
 
+/**
+ * Empties the cell of an item, which stays in the field and can be added
+ * again anywhere. Together with add_item_to_field(), items can be put
+ * back where they were without following the rules of their moves.
+ */
+void remove_item_from_field(Field field, Item item);
+
+/**
+ * Adds an item to every cell of the border of the field. Huge fields are
+ * sparse and do not store these cells: they are found arithmetically,
+ * and cannot be emptied.
+ */
+void add_border_to_field(Field field, Item item);
+
+/**
+ * Copies a field where each of the original items is replaced by its
+ * clone, at the same position. Other items are kept as they are.
+ */
+Field clone_field(Field field,
+                  const Item* originals,
+                  const Item* clones,
+                  size_t number_items);
+
+/**
+ * Same as clone_field(), but the copy comes from the arena, with all its
+ * memory, and is only freed with it. Returns NULL if it does not fit.
+ */
+Field clone_field_in_arena(Arena arena,
+                           Field field,
+                           const Item* originals,
+                           const Item* clones,
+                           size_t number_items);
+
+/**
+ * Bytes taken by the field and its grid, but not by the chunks of sparse
+ * fields or the slots of items beyond the first ones.
+ */
+size_t get_field_memory_size(Field field);
+
 #endif // FIELD_H
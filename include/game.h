@@ -1,13 +1,20 @@
 #ifndef GAME_H
 #define GAME_H
 
+// Standard headers
+#include <stdbool.h>
+#include <stdint.h>
+
 // Internal headers
 #include "position.h"
 #include "direction.h"
 #include "dimension.h"
 #include "field.h"
+#include "histogram.h"
 #include "item.h"
 #include "map.h"
+#include "renderer.h"
+#include "replay.h"
 #include "spy.h"
 
 // Structs
@@ -18,6 +25,15 @@
  */
 typedef struct game* Game;
 
+/**
+ * A game pool creates games with the same configuration in a single arena
+ * and reuses them: released games are acquired again, reset to their
+ * start, so once the pool has as many games as are played at the same
+ * time, playing more games allocates no memory. Pooled games must be
+ * released instead of deleted, and are seeded like any other game.
+ */
+typedef struct game_pool* GamePool;
+
 /**
  * A player strategy is a function to determine the direction of a player
  * given its current position in a Field. Aditionally, players can spy
@@ -25,6 +41,140 @@ typedef struct game* Game;
  */
 typedef direction_t (*PlayerStrategy)(position_t, Spy);
 
+/**
+ * A contextual strategy is a PlayerStrategy whose state lives in an
+ * explicit context rather than in static variables. A Game creates one
+ * context per player and deletes it with the Game, so many independent
+ * games can be played in the same process, even in different threads.
+ * Contexts own their random numbers, restarted by reset_context().
+ * Parameters, if any, are given to new_context() for every context.
+ */
+struct contextual_strategy {
+  void* (*new_context)(const void* parameters);
+  void (*reset_context)(void* context, uint64_t seed);
+  void (*delete_context)(void* context);
+  direction_t (*execute)(void* context, position_t, Spy);
+  const void* parameters;
+};
+typedef struct contextual_strategy contextual_strategy_t;
+
+/**
+ * The player who won a Game, if any.
+ */
+typedef enum {
+  WINNER_NONE, WINNER_ATTACKER, WINNER_DEFENDER,
+} Winner;
+
+/**
+ * Why a Game was over. When a player cheats, its opponent is the winner.
+ */
+typedef enum {
+  REASON_CAPTURE, REASON_GOAL, REASON_CHEATING, REASON_DRAW,
+} GameOverReason;
+
+/**
+ * A game result summarizes how a Game ended, without printing anything.
+ * Spy uses count how many times each player spied on its opponent.
+ */
+struct game_result {
+  Winner winner;
+  GameOverReason reason;
+  size_t turns;
+  size_t attacker_spy_uses;
+  size_t defender_spy_uses;
+  size_t attacker_timeouts;
+  size_t defender_timeouts;
+};
+typedef struct game_result game_result_t;
+
+/**
+ * What a player does when its strategy misses the deadline.
+ */
+typedef enum {
+  FALLBACK_STAY, FALLBACK_LAST_DIRECTION,
+} FallbackMove;
+
+/**
+ * A deadline limits how long each strategy call may take, in nanoseconds,
+ * or not at all if it is zero. Strategies cannot be interrupted, so a late
+ * direction is replaced by the fallback move and counted as a timeout.
+ */
+struct deadline {
+  uint64_t time;
+  FallbackMove fallback;
+};
+typedef struct deadline deadline_t;
+
+/**
+ * A strategy clock times the calls of the strategy of a player.
+ * It applies the deadline, records latencies if it has a histogram and
+ * keeps the last direction and the number of timeouts of a game.
+ */
+struct strategy_clock {
+  deadline_t deadline;
+  Histogram latencies;
+  direction_t last_direction;
+  size_t timeouts;
+};
+typedef struct strategy_clock strategy_clock_t;
+
+/**
+ * A game observer is notified of the events of a Game, with its own data:
+ * when the game starts, when a player spies on its opponent, when a turn
+ * ends and when the game ends. Any callback may be NULL. Observers are
+ * called in the order they were added, and a Game without observers
+ * does not pay for them beyond checking that there are none.
+ */
+struct game_observer {
+  void (*on_game_start)(void* data, Game game);
+  void (*on_spy_use)(void* data,
+                     Game game,
+                     size_t turn,
+                     ReplayPlayer player,
+                     size_t spy_uses);
+  void (*on_turn_end)(void* data,
+                      Game game,
+                      size_t turn,
+                      replay_move_t attacker_move,
+                      replay_move_t defender_move);
+  void (*on_game_end)(void* data, Game game, game_result_t result);
+  void* data;
+};
+typedef struct game_observer game_observer_t;
+
+/**
+ * A game snapshot has everything that changes while a Game is played,
+ * except the contexts of the strategies, so it can be stored by value
+ * and restored later in the same game or in any of its clones.
+ */
+struct game_snapshot {
+  position_t attacker_position;
+  position_t defender_position;
+  size_t attacker_spy_uses;
+  size_t defender_spy_uses;
+  size_t attacker_timeouts;
+  size_t defender_timeouts;
+  direction_t attacker_last_direction;
+  direction_t defender_last_direction;
+};
+typedef struct game_snapshot game_snapshot_t;
+
+/**
+ * A game undo has what make_game_move() changed, so unmake_game_move()
+ * can revert it in constant time.
+ */
+struct game_undo {
+  position_t attacker_position;
+  position_t defender_position;
+};
+typedef struct game_undo game_undo_t;
+
+// Macros
+#define GAME_MAX_OBSERVERS 8
+#define NULL_GAME_RESULT { WINNER_NONE, REASON_DRAW, 0, 0, 0, 0, 0 }
+#define NO_DEADLINE { 0, FALLBACK_STAY }
+#define NULL_STRATEGY_CLOCK { NO_DEADLINE, NULL, DIR_STAY, 0 }
+
 // Functions
 Game new_game(
     dimension_t field_dimension,
@@ -38,8 +188,110 @@ Game new_game_from_map(
     PlayerStrategy attacker_strategy,
     PlayerStrategy defender_strategy);
 
+Game new_contextual_game(
+    dimension_t field_dimension,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy);
+
+Game new_contextual_game_from_map(
+    Map map,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy);
+
 void delete_game(Game game);
+
+/**
+ * Copies a Game in its current state, with the same strategies but new
+ * contexts, which should be seeded with seed_game(). Clones have no
+ * observers and do not record latencies. Besides the contexts, a clone
+ * is usually allocated in a single block, with its copy of the field.
+ */
+Game clone_game(Game game);
+
+game_snapshot_t snapshot_game(Game game);
+void restore_game(Game game, game_snapshot_t snapshot);
+
+/**
+ * Moves the attacker and then the defender in the given directions,
+ * without calling their strategies, for searches that look ahead.
+ * Neither allocates memory, except in sparse fields, where a player that
+ * first enters a chunk of empty cells allocates it once. A player whose
+ * chunk cannot be allocated stays where it is.
+ */
+game_undo_t make_game_move(Game game,
+                           direction_t attacker_direction,
+                           direction_t defender_direction);
+void unmake_game_move(Game game, game_undo_t undo);
+
+/**
+ * Puts the players back where they started and clears their spy uses,
+ * timeouts and last directions, keeping the memory and the settings of
+ * the game. Strategies are restarted when the game is seeded again.
+ */
+void reset_game(Game game);
+
+/**
+ * Without a map, games of the pool are played in a standard field
+ * with the given dimension.
+ */
+GamePool new_game_pool(
+    Map map,
+    dimension_t field_dimension,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy);
+void delete_game_pool(GamePool pool);
+
+/**
+ * Returns a game in its start, without observers or other settings,
+ * or NULL if it could not be created.
+ */
+Game acquire_pooled_game(GamePool pool);
+
+/**
+ * Returns the game to the pool. Games of other pools and games already
+ * released are ignored.
+ */
+void release_pooled_game(GamePool pool, Game game);
+
+/**
+ * Checks if the Game is over in its current state and, if so, fills
+ * the result, whose number of turns is zero.
+ */
+bool is_game_over(Game game, game_result_t* result);
+
+void seed_game(Game game, uint64_t seed);
+void set_game_latency_histograms(Game game,
+                                 Histogram attacker_latencies,
+                                 Histogram defender_latencies);
+void set_game_deadline(Game game, deadline_t deadline);
+void set_game_replay(Game game, Replay replay);
+bool add_game_observer(Game game, game_observer_t observer);
+void remove_game_observers(Game game);
+Field get_game_field(Game game);
+void set_game_render_mode(Game game, RenderMode render_mode);
+void set_game_async_rendering(Game game,
+                              bool is_rendering_async,
+                              bool is_dropping_frames);
 void print_game(Game game);
-void play_game(Game game, size_t max_turns);
+game_result_t play_game(Game game, size_t max_turns);
+game_result_t play_game_quietly(Game game, size_t max_turns);
+
+void print_game_result(game_result_t result, size_t max_number_spies);
+
+direction_t execute_clocked_strategy(contextual_strategy_t strategy,
+                                     void* context,
+                                     position_t position,
+                                     Spy opponent_spy,
+                                     strategy_clock_t* clock);
+
+/**
+ * Time left before the deadline of the strategy call running in the
+ * current thread, in nanoseconds, so a strategy can return the best
+ * direction it found so far. Without a deadline, returns UINT64_MAX.
+ */
+uint64_t get_strategy_remaining_time(void);
 
 #endif // GAME_H
@@ -0,0 +1,29 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+// Standard headers
+#include <stdint.h>
+
+// Structs
+
+/**
+ * A histogram counts values in buckets whose width grows with the value,
+ * so every recorded value is kept with about 3% of precision.
+ * Recording does not lock: each thread records in its own histogram,
+ * and histograms are merged once the threads finish.
+ */
+typedef struct histogram* Histogram;
+
+// Functions
+Histogram new_histogram(void);
+void delete_histogram(Histogram histogram);
+void reset_histogram(Histogram histogram);
+
+void record_histogram_value(Histogram histogram, uint64_t value);
+void merge_histograms(Histogram histogram, Histogram other);
+
+uint64_t get_histogram_count(Histogram histogram);
+uint64_t get_histogram_max(Histogram histogram);
+uint64_t get_histogram_percentile(Histogram histogram, double percentile);
+
+#endif // HISTOGRAM_H
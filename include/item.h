@@ -3,8 +3,10 @@
 
 // Standard headers
 #include <stdbool.h>
+#include <stddef.h>
 
 // Internal headers
+#include "arena.h"
 #include "position.h"
 
 // Structs
@@ -16,6 +18,7 @@ typedef struct item* Item;
 
 // Functions
 Item new_item(char symbol, bool is_movable);
+Item new_item_in_arena(Arena arena, char symbol, bool is_movable);
 void delete_item(Item item);
 
 bool is_item_movable(Item item);
@@ -24,6 +27,13 @@ char get_item_symbol(Item item);
 position_t get_item_position(Item item);
 void set_item_position(Item item, position_t new_position);
 
+/**
+ * Code of the item in the last field where it was added, which the field
+ * uses to find it without a search. Zero if it was never in a field.
+ */
+size_t get_item_field_code(Item item);
+void set_item_field_code(Item item, size_t field_code);
+
 bool equal_items(Item p1, Item p2);
 
 #endif // ITEM_H
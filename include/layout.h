@@ -0,0 +1,40 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+// Standard headers
+#include <stddef.h>
+
+// Internal headers
+#include "dimension.h"
+
+// Structs
+
+/**
+ * How the cells of a 2D grid are laid out in memory. Row-major grids keep
+ * each row contiguous, so the neighbors of a cell in other rows are a
+ * whole row away. Tiled grids store square tiles of TILE_SIZE cells per
+ * side one after the other, row by row, so the neighbors of a cell are
+ * usually in its own tile: for cells of one byte, a single cache line.
+ * Tiled grids are padded to a whole number of tiles.
+ */
+typedef enum {
+  LAYOUT_ROW_MAJOR, LAYOUT_TILED,
+} GridLayout;
+
+// Macros
+#define TILE_SIZE 8
+#define TILED_LAYOUT_MIN_CELLS (1UL << 16) // Grids that do not fit in L1
+
+#define TILES_PER_LINE(length) (((length) + TILE_SIZE - 1) / TILE_SIZE)
+
+#define TILED_INDEX(i, j, tiles_per_row) \
+  ((((i) / TILE_SIZE * (tiles_per_row) + (j) / TILE_SIZE) * TILE_SIZE \
+    + (i) % TILE_SIZE) * TILE_SIZE + (j) % TILE_SIZE)
+
+#define LAYOUT_NUMBER_CELLS(layout, dimension) \
+  ((layout) == LAYOUT_TILED \
+    ? TILES_PER_LINE((dimension).height) * TILES_PER_LINE((dimension).width) \
+      * TILE_SIZE * TILE_SIZE \
+    : (dimension).height * (dimension).width)
+
+#endif // LAYOUT_H
@@ -1,14 +1,22 @@
 #ifndef MAP_H
 #define MAP_H
 
+// Standard headers
+#include <stdbool.h>
+#include <stdint.h>
+
 // Internal headers
 #include "dimension.h"
 #include "position.h"
 
+// Macros
+#define MAP_SYMBOLS "XAD."
+
 // Structs
 
 /**
  * A map is 2D grid memory representation of the layout of a Game.
+ * It is read from a text file or from a binary file compiled by mapc.
  */
 typedef struct map* Map;
 
@@ -21,4 +29,18 @@ void print_map(Map map);
 dimension_t get_map_dimension(Map map);
 char get_map_symbol(Map map, position_t position);
 
+size_t get_map_symbol_occurrences(Map map, char symbol);
+
+/**
+ * Whether the symbol appears more than max_occurrences times in the map.
+ * Symbols may appear any number of times if max_occurrences is zero.
+ */
+bool has_map_exceeded_max_occurrences_of_symbol(Map map,
+                                                char symbol,
+                                                size_t max_occurrences);
+position_t get_map_symbol_position(Map map, char symbol);
+
+uint64_t get_map_hash(Map map);
+bool write_compiled_map(Map map, const char* compiled_map_path);
+
 #endif // MAP_H
@@ -0,0 +1,72 @@
+#ifndef MCTS_ATTACKER_H
+#define MCTS_ATTACKER_H
+
+// Standard headers
+#include <stddef.h>
+#include <stdint.h>
+
+// Internal headers
+#include "dimension.h"
+#include "direction.h"
+#include "distance_field.h"
+#include "map.h"
+#include "position.h"
+#include "spy.h"
+
+// Structs
+
+/**
+ * Parameters of the Monte Carlo tree search attacker. It simulates games
+ * in the field of the map or, if it is NULL, in a standard field with the
+ * given dimension. Every turn, number_rollouts rollouts of at most
+ * rollout_depth turns are split among number_threads threads, which build
+ * their own trees and add up the visits of the moves from the root.
+ * Searches also stop early if the strategy deadline is about to be missed.
+ * Rollouts are guided by the distance field of the field, which should be
+ * computed once and shared by all games. If it is NULL, each context
+ * computes its own.
+ */
+struct mcts_parameters {
+  Map map;
+  DistanceField distance_field;
+  dimension_t field_dimension;
+  size_t number_rollouts;
+  size_t rollout_depth;
+  size_t number_threads;
+};
+typedef struct mcts_parameters mcts_parameters_t;
+
+// Macros
+#define MCTS_MAX_THREADS 64
+#define DEFAULT_MCTS_PARAMETERS { NULL, NULL, { 10, 10 }, 1000, 16, 1 }
+
+/**
+ * The MCTS attacker, to be given to new_contextual_game() as a
+ * contextual_strategy_t. The parameters must outlive the games.
+ */
+#define MCTS_ATTACKER_CONTEXTUAL_STRATEGY(parameters) { \
+  new_mcts_attacker_context, \
+  reset_mcts_attacker_context, \
+  delete_mcts_attacker_context, \
+  execute_mcts_attacker_strategy, \
+  (parameters), \
+}
+
+// Functions
+
+/**
+ * The attacker spies on the defender in its first turn, and its rollouts
+ * start with the defender where it was seen. Rollouts play random moves
+ * biased towards the goal against a defender that moves at random and
+ * sometimes chases the attacker, and the move visited the most from the
+ * root is chosen.
+ */
+void* new_mcts_attacker_context(const void* parameters);
+void reset_mcts_attacker_context(void* mcts_attacker_context, uint64_t seed);
+void delete_mcts_attacker_context(void* mcts_attacker_context);
+
+direction_t execute_mcts_attacker_strategy(void* mcts_attacker_context,
+                                           position_t attacker_position,
+                                           Spy defender_spy);
+
+#endif // MCTS_ATTACKER_H
@@ -0,0 +1,35 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+// Standard headers
+#include <stdint.h>
+
+// Structs
+
+/**
+ * A random number generator (xoshiro256**) whose whole state is kept
+ * by value, so that each game can own one instead of sharing rand()'s
+ * global (and locked) state. The same seed always gives the same numbers.
+ */
+struct rng {
+  uint64_t state[4];
+};
+typedef struct rng rng_t;
+
+// Functions
+rng_t new_rng(uint64_t seed);
+
+uint64_t next_rng(rng_t* rng);
+
+/**
+ * Next random number in [0, RAND_MAX], as a drop-in for rand().
+ */
+int next_rng_int(rng_t* rng);
+
+/**
+ * Derives an independent seed from a seed and a stream number,
+ * e.g. a master seed and the index of a game in a tournament.
+ */
+uint64_t mix_seed(uint64_t seed, uint64_t stream);
+
+#endif // RANDOM_H
@@ -0,0 +1,52 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+// Standard headers
+#include <stddef.h>
+
+// Internal headers
+#include "dimension.h"
+#include "field.h"
+
+// Structs
+
+/**
+ * A renderer draws the frames of a Game: a turn header followed by the
+ * field grid. Each frame is built in a buffer reused across frames and
+ * written with a single write(), so fields of any size are drawn without
+ * a call per cell. In RENDER_DIFF mode, only the first frame is drawn in
+ * full, and the next ones move the cursor with ANSI escape codes to
+ * redraw only the cells that changed.
+ */
+typedef struct renderer* Renderer;
+
+/**
+ * How a renderer draws its frames.
+ */
+typedef enum {
+  RENDER_FULL, RENDER_DIFF,
+} RenderMode;
+
+// Functions
+Renderer new_renderer(dimension_t dimension,
+                      RenderMode mode,
+                      int file_descriptor);
+void delete_renderer(Renderer renderer);
+
+/**
+ * Fields must have the dimension of the renderer, or nothing is drawn.
+ */
+void render_field(Renderer renderer, Field field, size_t turn);
+
+/**
+ * Draws only the grid of the field, in full and without a turn header.
+ */
+void render_field_grid(Renderer renderer, Field field);
+
+/**
+ * Same as render_field(), but with a grid as written by write_field_grid()
+ * for a field with the dimension of the renderer.
+ */
+void render_grid(Renderer renderer, const char* grid, size_t turn);
+
+#endif // RENDERER_H
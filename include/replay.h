@@ -0,0 +1,97 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// Standard headers
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Internal headers
+#include "direction.h"
+#include "position.h"
+#include "spy.h"
+
+// Structs
+
+/**
+ * A replay records the moves of a Game turn by turn, so it can be stored
+ * in a few bytes and played again later. Each direction takes 4 bits,
+ * and spy uses are stored as a list of events, which is usually empty.
+ * The hash of the map where the game was played is kept to check that
+ * it is replayed in the same map.
+ */
+typedef struct replay* Replay;
+
+/**
+ * The move of a player in a turn: its direction and how many times
+ * it spied on its opponent (at most 15 are recorded per turn).
+ */
+struct replay_move {
+  direction_t direction;
+  size_t spy_uses;
+};
+typedef struct replay_move replay_move_t;
+
+/**
+ * The player of a move in a replay.
+ */
+typedef enum {
+  REPLAY_ATTACKER, REPLAY_DEFENDER,
+} ReplayPlayer;
+
+// Macros
+
+/**
+ * The most turns a replay can hold, limited by its 16-bit spy events.
+ */
+#define REPLAY_MAX_TURNS (UINT16_MAX / 2)
+
+/**
+ * Strategies that play the moves of a replay, to be given
+ * to new_contextual_game() as a contextual_strategy_t.
+ * The replay must outlive the games that use them.
+ */
+#define ATTACKER_REPLAY_STRATEGY(replay) { \
+  new_attacker_replay_context, \
+  reset_replay_context, \
+  delete_replay_context, \
+  execute_replay_strategy, \
+  (replay), \
+}
+
+#define DEFENDER_REPLAY_STRATEGY(replay) { \
+  new_defender_replay_context, \
+  reset_replay_context, \
+  delete_replay_context, \
+  execute_replay_strategy, \
+  (replay), \
+}
+
+// Functions
+Replay new_replay(void);
+Replay load_replay(const char* replay_path);
+void delete_replay(Replay replay);
+
+bool save_replay(Replay replay, const char* replay_path);
+
+void set_replay_map_hash(Replay replay, uint64_t map_hash);
+uint64_t get_replay_map_hash(Replay replay);
+
+size_t get_replay_number_turns(Replay replay);
+bool record_replay_turn(Replay replay,
+                        replay_move_t attacker_move,
+                        replay_move_t defender_move);
+replay_move_t get_replay_move(Replay replay,
+                              size_t turn,
+                              ReplayPlayer player);
+
+void* new_attacker_replay_context(const void* replay);
+void* new_defender_replay_context(const void* replay);
+void reset_replay_context(void* replay_context, uint64_t seed);
+void delete_replay_context(void* replay_context);
+
+direction_t execute_replay_strategy(void* replay_context,
+                                    position_t position,
+                                    Spy opponent_spy);
+
+#endif // REPLAY_H
@@ -0,0 +1,49 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+// Standard headers
+#include <stddef.h>
+
+// Internal headers
+#include "position.h"
+
+// Structs
+
+/**
+ * A spatial hash indexes entries by their position in a uniform grid of
+ * buckets, SPATIAL_HASH_BUCKET_SIZE cells per side, so the entries near
+ * a position are found by looking only at the buckets around it, however
+ * many entries there are. Buckets are kept in a hash table sized for the
+ * maximum number of entries, not for the field, so huge fields cost no
+ * more than small ones. Entries are identified by an index below the
+ * maximum number of entries, and each is in at most one position.
+ */
+typedef struct spatial_hash* SpatialHash;
+
+// Macros
+#define SPATIAL_HASH_BUCKET_SIZE 4
+
+// Functions
+SpatialHash new_spatial_hash(size_t max_entries);
+void delete_spatial_hash(SpatialHash spatial_hash);
+
+/**
+ * Puts the entry in the position, moving it if it is already in the hash.
+ */
+void insert_into_spatial_hash(SpatialHash spatial_hash,
+                              size_t entry,
+                              position_t position);
+void remove_from_spatial_hash(SpatialHash spatial_hash, size_t entry);
+
+/**
+ * Finds the entries at most radius cells away from the center in each
+ * coordinate, storing up to max_found of them in found_entries, and
+ * returns how many were stored.
+ */
+size_t query_spatial_hash(SpatialHash spatial_hash,
+                          position_t center,
+                          size_t radius,
+                          size_t* found_entries,
+                          size_t max_found);
+
+#endif // SPATIAL_HASH_H
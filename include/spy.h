@@ -5,6 +5,7 @@
 #include <stddef.h>
 
 // Internal headers
+#include "arena.h"
 #include "item.h"
 #include "position.h"
 
@@ -18,9 +19,12 @@ typedef struct spy* Spy;
 
 // Functions
 Spy new_spy(Item item);
+Spy new_spy_in_arena(Arena arena, Item item);
 void delete_spy(Spy spy);
+void reset_spy(Spy spy);
 
 position_t get_spy_position(Spy spy);
 size_t get_spy_number_uses(Spy spy);
+void set_spy_number_uses(Spy spy, size_t number_uses);
 
 #endif // SPY_H
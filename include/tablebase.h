@@ -0,0 +1,112 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+// Standard headers
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Internal headers
+#include "dimension.h"
+#include "direction.h"
+#include "game.h"
+#include "map.h"
+#include "position.h"
+#include "replay.h"
+
+// Structs
+
+/**
+ * A tablebase has the game-theoretic outcome of every state of a map, and
+ * how many moves (of either player) it takes to get there with perfect
+ * play, when both players know where the other is. A state is given by
+ * the positions of the attacker and the defender and whose move it is.
+ * Each turn the attacker moves and then the defender, and only after both
+ * moves the game may be over, by the same rules as play_game().
+ * Entries take 16 bits, and saved tablebases are mapped into memory
+ * when loaded, so they are never read as a whole.
+ */
+typedef struct tablebase* Tablebase;
+
+/**
+ * Outcome of a state. Players cannot win from draws, and states with a
+ * player on an obstacle or both players in the same cell are invalid.
+ */
+typedef enum {
+  OUTCOME_DRAW, OUTCOME_ATTACKER_WINS, OUTCOME_DEFENDER_WINS, OUTCOME_INVALID,
+} Outcome;
+
+struct tablebase_entry {
+  Outcome outcome;
+  size_t distance;
+};
+typedef struct tablebase_entry tablebase_entry_t;
+
+/**
+ * How many moves of each player were mistakes, i.e. made the outcome
+ * of the game worse for the player, according to a tablebase.
+ */
+struct tablebase_score {
+  size_t attacker_moves;
+  size_t attacker_mistakes;
+  size_t defender_moves;
+  size_t defender_mistakes;
+};
+typedef struct tablebase_score tablebase_score_t;
+
+/**
+ * An oracle scores the moves of the games it observes with a tablebase,
+ * keeping the positions of the players before each turn.
+ */
+struct tablebase_oracle {
+  Tablebase tablebase;
+  position_t attacker_position;
+  position_t defender_position;
+  tablebase_score_t score;
+};
+typedef struct tablebase_oracle tablebase_oracle_t;
+
+// Macros
+#define NULL_TABLEBASE_SCORE { 0, 0, 0, 0 }
+
+// Functions
+
+/**
+ * Solves every state of the map by retrograde analysis, split among
+ * number_threads threads. Returns NULL if the map has no attacker
+ * or no defender.
+ */
+Tablebase generate_tablebase(Map map, size_t number_threads);
+Tablebase load_tablebase(const char* tablebase_path);
+bool save_tablebase(Tablebase tablebase, const char* tablebase_path);
+void delete_tablebase(Tablebase tablebase);
+
+dimension_t get_tablebase_dimension(Tablebase tablebase);
+uint64_t get_tablebase_map_hash(Tablebase tablebase);
+size_t get_tablebase_max_distance(Tablebase tablebase);
+
+/**
+ * Whether the tablebase was generated for a map with obstacles exactly on
+ * its borders, so it also solves games without a map of its dimension.
+ */
+bool is_tablebase_of_bordered_field(Tablebase tablebase);
+
+tablebase_entry_t probe_tablebase(Tablebase tablebase,
+                                  position_t attacker_position,
+                                  position_t defender_position,
+                                  ReplayPlayer player_to_move);
+
+/**
+ * Best move of the player to move: the fastest win, a draw or, if it
+ * cannot avoid losing, the slowest loss.
+ */
+direction_t get_tablebase_move(Tablebase tablebase,
+                               position_t attacker_position,
+                               position_t defender_position,
+                               ReplayPlayer player_to_move);
+
+game_observer_t make_tablebase_observer(tablebase_oracle_t* oracle);
+void merge_tablebase_scores(tablebase_score_t* score,
+                            tablebase_score_t other);
+
+#endif // TABLEBASE_H
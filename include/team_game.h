@@ -0,0 +1,81 @@
+#ifndef TEAM_GAME_H
+#define TEAM_GAME_H
+
+// Standard headers
+#include <stddef.h>
+#include <stdint.h>
+
+// Internal headers
+#include "dimension.h"
+#include "field.h"
+#include "game.h"
+#include "map.h"
+#include "renderer.h"
+
+// Structs
+
+/**
+ * A team game is played by a team of attackers against a team of
+ * defenders. Every turn, each attacker moves, in order, and then each
+ * defender. An attacker is captured, and leaves the field, when a
+ * defender is in any of its 8 neighbor cells at the end of a turn. The
+ * attackers win when any of them reaches the goal column, and the
+ * defenders win when all attackers are captured. Each player has its
+ * own strategy context and spies on one opponent, the one with its index
+ * in the other team (wrapping around), at most max_number_spies times.
+ * Players are found in the field by their item code, and defenders are
+ * kept in a spatial hash, so moves and captures take time proportional
+ * to the number of players each turn, not to the number of pairs.
+ */
+typedef struct team_game* TeamGame;
+
+// Macros
+#define TEAM_MAX_PLAYERS ((FIELD_MAX_ITEMS - 1) / 2) // With the obstacles
+
+// Functions
+
+/**
+ * Team game in a standard field, with borders, where the attackers start
+ * spread over its second column and the defenders over its next to last
+ * one. Returns NULL if the teams do not fit in the field.
+ */
+TeamGame new_team_game(
+    dimension_t field_dimension,
+    size_t number_attackers,
+    size_t number_defenders,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy);
+
+/**
+ * Team game whose players are the 'A' and 'D' cells of the map, numbered
+ * in reading order. Returns NULL if a team is missing or has more players
+ * than its maximum, or than TEAM_MAX_PLAYERS.
+ */
+TeamGame new_team_game_from_map(
+    Map map,
+    size_t max_number_attackers,
+    size_t max_number_defenders,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy);
+
+void delete_team_game(TeamGame game);
+
+/**
+ * Restarts the strategies of every player with independent seeds. With
+ * one player per team, they get the same seeds as in seed_game().
+ */
+void seed_team_game(TeamGame game, uint64_t seed);
+
+Field get_team_game_field(TeamGame game);
+size_t get_team_game_captures(TeamGame game);
+void set_team_game_render_mode(TeamGame game, RenderMode render_mode);
+
+/**
+ * Spy uses in the result are summed over each team.
+ */
+game_result_t play_team_game(TeamGame game, size_t max_turns);
+game_result_t play_team_game_quietly(TeamGame game, size_t max_turns);
+
+#endif // TEAM_GAME_H
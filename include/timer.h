@@ -0,0 +1,15 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+// Standard headers
+#include <stdint.h>
+
+// Functions
+
+/**
+ * Current time of a monotonic clock, in nanoseconds.
+ * Only differences between two readings are meaningful.
+ */
+uint64_t get_monotonic_time(void);
+
+#endif // TIMER_H
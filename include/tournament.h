@@ -0,0 +1,96 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+// Standard headers
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Internal headers
+#include "dimension.h"
+#include "game.h"
+#include "histogram.h"
+#include "map.h"
+#include "tablebase.h"
+
+// Structs
+
+/**
+ * A tournament is a number of games with the same configuration,
+ * played in parallel by a pool of threads. Games are played in the
+ * field described by map or, if it is NULL, in a standard field with
+ * the given dimension. Strategies must keep all their state in their
+ * contexts, as each thread creates its own games. Each game is seeded
+ * from the tournament seed and its index, so results do not depend on
+ * the number of threads. If batch_size is not zero, each thread plays
+ * its games batch_size at a time in a Batch, with the same results.
+ * If the latency histograms are not NULL, each thread records how long
+ * the strategy calls take in its own histograms, merged into these
+ * once all games are played. Every strategy call is limited by the
+ * deadline, if it has one. If the tablebase is not NULL, the moves of
+ * every game are scored against it, which batches cannot do.
+ */
+struct tournament {
+  Map map;
+  dimension_t field_dimension;
+  size_t max_number_spies;
+  size_t max_turns;
+
+  contextual_strategy_t attacker_strategy;
+  contextual_strategy_t defender_strategy;
+
+  size_t number_games;
+  size_t number_threads;
+  size_t batch_size;
+  uint64_t seed;
+  deadline_t deadline;
+
+  Histogram attacker_latencies;
+  Histogram defender_latencies;
+
+  Tablebase tablebase;
+};
+typedef struct tournament tournament_t;
+
+/**
+ * Statistics aggregate the results of many games and how long
+ * it took to play them, in nanoseconds.
+ */
+struct statistics {
+  size_t games;
+  size_t attacker_wins;
+  size_t defender_wins;
+  size_t draws;
+  size_t cheats;
+  size_t timeouts;
+  size_t turns;
+  uint64_t elapsed_time;
+  tablebase_score_t score;
+};
+typedef struct statistics statistics_t;
+
+// Macros
+#define NULL_STATISTICS { 0, 0, 0, 0, 0, 0, 0, 0, NULL_TABLEBASE_SCORE }
+
+// Functions
+
+/**
+ * Plays all games of the tournament and returns their merged statistics.
+ * If thread_statistics is not NULL, it should have room for
+ * number_threads entries, which receive the statistics of each thread.
+ * Returns NULL_STATISTICS if any game could not be created.
+ */
+statistics_t play_tournament(tournament_t tournament,
+                             statistics_t* thread_statistics);
+
+void add_result_to_statistics(statistics_t* statistics,
+                              game_result_t result);
+void merge_statistics(statistics_t* statistics, statistics_t other);
+
+/**
+ * Observer that adds the result of every game it observes
+ * to the statistics, which must outlive the games.
+ */
+game_observer_t make_statistics_observer(statistics_t* statistics);
+
+#endif // TOURNAMENT_H
@@ -0,0 +1,162 @@
+// Standard headers
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Main header
+#include "arena.h"
+
+// Macros
+#define ARENA_ALIGNMENT _Alignof(max_align_t)
+#define ALIGN_UP(size) \
+  (((size) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT)
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Blocks form a list from the first allocated to the last one, and
+ * memory is given from the current block, allocated together with it.
+ */
+struct block {
+  struct block* next;
+  size_t size;
+  max_align_t memory[];
+};
+typedef struct block block_t;
+
+struct arena {
+  size_t block_size;
+
+  block_t* first_block;
+  block_t* current_block;
+  size_t current_used;
+
+  // Of blocks before the current one, whose unused ends are wasted
+  size_t previous_used;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+block_t* next_arena_block(Arena arena, size_t size);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+Arena new_arena(size_t block_size) {
+  Arena arena = malloc(sizeof(*arena));
+  if (arena == NULL) return NULL;
+
+  arena->block_size = block_size > 0 ? ALIGN_UP(block_size) : ARENA_ALIGNMENT;
+  arena->first_block = NULL;
+  arena->current_block = NULL;
+  arena->current_used = 0;
+  arena->previous_used = 0;
+
+  return arena;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_arena(Arena arena) {
+  if (arena == NULL) return;
+
+  block_t* block = arena->first_block;
+  while (block != NULL) {
+    block_t* next = block->next;
+    free(block);
+    block = next;
+  }
+
+  free(arena);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* allocate_from_arena(Arena arena, size_t size) {
+  if (arena == NULL) return NULL;
+
+  size = ALIGN_UP(size);
+
+  block_t* block = arena->current_block;
+  if (block == NULL || arena->current_used + size > block->size) {
+    block = next_arena_block(arena, size);
+    if (block == NULL) return NULL;
+  }
+
+  void* memory = (char*) block->memory + arena->current_used;
+  arena->current_used += size;
+
+  return memory;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void clear_arena(Arena arena) {
+  if (arena == NULL) return;
+
+  arena->current_block = arena->first_block;
+  arena->current_used = 0;
+  arena->previous_used = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_arena_used_size(Arena arena) {
+  if (arena == NULL) return 0;
+  return arena->previous_used + arena->current_used;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_arena_reserved_size(Arena arena) {
+  if (arena == NULL) return 0;
+
+  size_t reserved_size = 0;
+  for (block_t* block = arena->first_block; block != NULL;
+       block = block->next) {
+    reserved_size += block->size;
+  }
+
+  return reserved_size;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+// Blocks kept by clear_arena() are reused in order while they are
+// large enough, and new blocks are only allocated after the last one
+block_t* next_arena_block(Arena arena, size_t size) {
+  block_t* current = arena->current_block;
+  block_t* next = current != NULL ? current->next : arena->first_block;
+
+  if (next == NULL || next->size < size) {
+    size_t block_size = size > arena->block_size ? size : arena->block_size;
+
+    block_t* block = malloc(sizeof(*block) + block_size);
+    if (block == NULL) return NULL;
+
+    block->size = block_size;
+    block->next = next;
+
+    if (current != NULL) {
+      current->next = block;
+    } else {
+      arena->first_block = block;
+    }
+    next = block;
+  }
+
+  if (current != NULL) arena->previous_used += arena->current_used;
+  arena->current_block = next;
+  arena->current_used = 0;
+
+  return next;
+}
+
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,281 @@
+// Standard headers
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Internal headers
+#include "field.h"
+#include "item.h"
+#include "renderer.h"
+
+// Main header
+#include "async_renderer.h"
+
+// Macros
+#define IDLE_SLEEP_TIME 50000 // nanoseconds
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * A frame only has the positions of the movable items, as the render
+ * thread already knows everything else in the field.
+ */
+struct frame {
+  uint32_t turn;
+  uint32_t positions[ASYNC_RENDERER_MAX_ITEMS][2];
+};
+typedef struct frame frame_t;
+
+struct async_renderer {
+  // Only used by the game thread
+  Item items[ASYNC_RENDERER_MAX_ITEMS];
+  size_t number_items;
+  bool is_dropping_frames;
+  size_t dropped_frames;
+
+  // Last frame dropped, pushed again when the game finishes
+  bool has_dropped_last_frame;
+  frame_t last_frame;
+
+  // Ring of frames: the game thread writes at the tail
+  // and the render thread reads at the head
+  frame_t frames[ASYNC_RENDERER_CAPACITY];
+  _Atomic size_t head;
+  _Atomic size_t tail;
+  _Atomic bool is_finished;
+
+  // Only used by the render thread
+  Renderer renderer;
+  char* grid;
+  size_t row_length;
+  char symbols[ASYNC_RENDERER_MAX_ITEMS];
+  uint32_t drawn_positions[ASYNC_RENDERER_MAX_ITEMS][2];
+
+  pthread_t thread;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+frame_t make_frame(AsyncRenderer async_renderer, size_t turn);
+bool try_push_frame(AsyncRenderer async_renderer, frame_t frame);
+
+void* run_render_thread(void* async_renderer);
+void draw_async_frame(AsyncRenderer async_renderer, const frame_t* frame);
+void wait_for_frames(void);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+AsyncRenderer new_async_renderer(Field field,
+                                 const Item* items,
+                                 size_t number_items,
+                                 RenderMode mode,
+                                 int file_descriptor,
+                                 bool is_dropping_frames) {
+  if (field == NULL || number_items > ASYNC_RENDERER_MAX_ITEMS) return NULL;
+
+  AsyncRenderer async_renderer = malloc(sizeof(*async_renderer));
+  if (async_renderer == NULL) return NULL;
+
+  memcpy(async_renderer->items, items, number_items * sizeof(*items));
+  async_renderer->number_items = number_items;
+  async_renderer->is_dropping_frames = is_dropping_frames;
+  async_renderer->dropped_frames = 0;
+  async_renderer->has_dropped_last_frame = false;
+
+  atomic_init(&async_renderer->head, 0);
+  atomic_init(&async_renderer->tail, 0);
+  atomic_init(&async_renderer->is_finished, false);
+
+  dimension_t dimension = get_field_dimension(field);
+  async_renderer->renderer
+    = new_renderer(dimension, mode, file_descriptor);
+  async_renderer->grid = malloc(get_field_grid_length(field));
+
+  if (async_renderer->renderer == NULL || async_renderer->grid == NULL) {
+    delete_renderer(async_renderer->renderer);
+    free(async_renderer->grid);
+    free(async_renderer);
+    return NULL;
+  }
+
+  async_renderer->row_length = 2 * dimension.width + 2;
+  write_field_grid(field, async_renderer->grid);
+
+  // The grid already has the items where they are now
+  for (size_t k = 0; k < number_items; k++) {
+    position_t position = get_item_position(items[k]);
+    async_renderer->symbols[k] = get_item_symbol(items[k]);
+    async_renderer->drawn_positions[k][0] = position.i;
+    async_renderer->drawn_positions[k][1] = position.j;
+  }
+
+  // Without the render thread, frames would wait for it forever
+  if (pthread_create(&async_renderer->thread, NULL,
+                     run_render_thread, async_renderer) != 0) {
+    delete_renderer(async_renderer->renderer);
+    free(async_renderer->grid);
+    free(async_renderer);
+    return NULL;
+  }
+
+  return async_renderer;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_async_renderer(AsyncRenderer async_renderer) {
+  if (async_renderer == NULL) return;
+
+  while (async_renderer->has_dropped_last_frame
+         && !try_push_frame(async_renderer, async_renderer->last_frame)) {
+    sched_yield();
+  }
+
+  atomic_store_explicit(&async_renderer->is_finished, true,
+                        memory_order_release);
+  pthread_join(async_renderer->thread, NULL);
+
+  delete_renderer(async_renderer->renderer);
+  free(async_renderer->grid);
+
+  free(async_renderer);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void push_async_frame(AsyncRenderer async_renderer, size_t turn) {
+  if (async_renderer == NULL) return;
+
+  frame_t frame = make_frame(async_renderer, turn);
+  async_renderer->has_dropped_last_frame = false;
+
+  while (!try_push_frame(async_renderer, frame)) {
+    if (async_renderer->is_dropping_frames) {
+      async_renderer->dropped_frames++;
+      async_renderer->has_dropped_last_frame = true;
+      async_renderer->last_frame = frame;
+      return;
+    }
+    sched_yield();
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_async_renderer_dropped_frames(AsyncRenderer async_renderer) {
+  if (async_renderer == NULL) return 0;
+  return async_renderer->dropped_frames;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+frame_t make_frame(AsyncRenderer async_renderer, size_t turn) {
+  frame_t frame = { .turn = turn };
+
+  for (size_t k = 0; k < async_renderer->number_items; k++) {
+    position_t position = get_item_position(async_renderer->items[k]);
+    frame.positions[k][0] = position.i;
+    frame.positions[k][1] = position.j;
+  }
+
+  return frame;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool try_push_frame(AsyncRenderer async_renderer, frame_t frame) {
+  size_t tail
+    = atomic_load_explicit(&async_renderer->tail, memory_order_relaxed);
+  size_t head
+    = atomic_load_explicit(&async_renderer->head, memory_order_acquire);
+
+  if (tail - head == ASYNC_RENDERER_CAPACITY) return false;
+
+  async_renderer->frames[tail % ASYNC_RENDERER_CAPACITY] = frame;
+  atomic_store_explicit(&async_renderer->tail, tail+1, memory_order_release);
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Draws frames until the game is finished and all frames were drawn.
+// Frames are copied out of the ring before the head moves, so the game
+// thread never writes a frame while it is being read
+void* run_render_thread(void* async_renderer) {
+  AsyncRenderer self = async_renderer;
+
+  while (true) {
+    size_t head = atomic_load_explicit(&self->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&self->tail, memory_order_acquire);
+
+    if (head == tail) {
+      if (atomic_load_explicit(&self->is_finished, memory_order_acquire)) {
+        // Frames may have been pushed just before the game finished
+        tail = atomic_load_explicit(&self->tail, memory_order_acquire);
+        if (head == tail) break;
+      } else {
+        wait_for_frames();
+        continue;
+      }
+    }
+
+    // When dropping frames, only the latest one is drawn
+    if (self->is_dropping_frames) head = tail-1;
+
+    frame_t frame = self->frames[head % ASYNC_RENDERER_CAPACITY];
+    atomic_store_explicit(&self->head, head+1, memory_order_release);
+
+    draw_async_frame(self, &frame);
+  }
+
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Items are first erased and then drawn, so they can take each other's
+// places in the same frame
+void draw_async_frame(AsyncRenderer async_renderer, const frame_t* frame) {
+  for (size_t k = 0; k < async_renderer->number_items; k++) {
+    uint32_t* position = async_renderer->drawn_positions[k];
+    size_t offset
+      = position[0] * async_renderer->row_length + 2 * position[1] + 1;
+    async_renderer->grid[offset] = ' ';
+  }
+
+  for (size_t k = 0; k < async_renderer->number_items; k++) {
+    uint32_t* position = async_renderer->drawn_positions[k];
+    position[0] = frame->positions[k][0];
+    position[1] = frame->positions[k][1];
+
+    size_t offset
+      = position[0] * async_renderer->row_length + 2 * position[1] + 1;
+    async_renderer->grid[offset] = async_renderer->symbols[k];
+  }
+
+  render_grid(async_renderer->renderer, async_renderer->grid, frame->turn);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void wait_for_frames(void) {
+  struct timespec idle_time = { 0, IDLE_SLEEP_TIME };
+  nanosleep(&idle_time, NULL);
+}
+
+/*----------------------------------------------------------------------------*/
@@ -8,6 +8,7 @@
 // Internal headers
 #include "direction.h"
 #include "position.h"
+#include "random.h"
 #include "spy.h"
 
 // Main header
@@ -43,6 +44,41 @@ const Strategy init_atk_strategies[] = {
   INIT_ZIGZAG, INIT_VERTICAL, INIT_TRIANGLE, INIT_SQUARE
 };
 
+/*----------------------------------------------------------------------------*/
+/*                                  CONTEXT                                   */
+/*----------------------------------------------------------------------------*/
+
+struct attacker_context {
+  // Game
+  int round;
+
+  // Strategy
+  StrategyType strategy_type;
+  StrategyType max_strategy_type;
+  Strategy strategy;
+  Way way;
+
+  // Lock management
+  int rounds_free;
+  direction_t last_dir;
+
+  // Positions to check against current position
+  position_t initial_pos;
+  position_t last_pos;
+
+  // Spy
+  bool already_spied;
+  int rounds_since_spy;
+  direction_t preferred_dir;
+
+  // SQUARE strategy progress
+  int square_step;
+  int squares_away;
+
+  // Random numbers
+  rng_t rng;
+};
+
 /*----------------------------------------------------------------------------*/
 /*                                    UTIL                                    */
 /*----------------------------------------------------------------------------*/
@@ -138,8 +174,8 @@ void set_way(Way *way, direction_t dir) {
   }
 }
 
-void set_rand_dir(direction_t *rand_dir, Way way) {
-  int k = rand();
+void set_rand_dir(direction_t *rand_dir, Way way, rng_t *rng) {
+  int k = next_rng_int(rng);
   if (way == CLOCKWISE) {
     if (k > RAND_MAX / 3) {
       // RIGHT at 67%
@@ -182,19 +218,19 @@ void update_strategy_type(
 /*                               STRATEGIES                                   */
 /*----------------------------------------------------------------------------*/
 
-void apply_zigzag(direction_t *dir, Strategy *s) {
+void apply_zigzag(direction_t *dir, Strategy *s, rng_t *rng) {
   // Treat preferred direction
   if (!is_same_dir(s->preferred_dir, (direction_t) DIR_STAY)) {
     *dir = s->preferred_dir;
   } else {
     // Resolve random way
     if (s->way == RANDOM) {
-      s->way = rand() % 2 == 0 ? CLOCKWISE : COUNTERCLOCKWISE;
+      s->way = next_rng_int(rng) % 2 == 0 ? CLOCKWISE : COUNTERCLOCKWISE;
     }
     // Go the same way with probability 7/8
-    if (rand() % 8 != 0) {
+    if (next_rng_int(rng) % 8 != 0) {
       // Keep going
-      set_rand_dir(dir, s->way);
+      set_rand_dir(dir, s->way, rng);
     } else {
       // Change way
       if (s->way == CLOCKWISE) {
@@ -243,43 +279,42 @@ void apply_triangle(direction_t *dir, Strategy *s) {
   s->rounds_left--;
 }
 
-void apply_square(direction_t *dir, Strategy *s, bool is_locked) {
-  static int step = 0;
-  static int squares_away = 0;
+void apply_square(direction_t *dir, Strategy *s, bool is_locked,
+                  struct attacker_context *context) {
   if (is_locked) {
-    if (step == 0) {
+    if (context->square_step == 0) {
       if (s->way == CLOCKWISE) {
         *dir = (direction_t) DIR_UP;
       } else {
         *dir = (direction_t) DIR_DOWN;
       }
-      step++;
-    } else if (step == 1) {
+      context->square_step++;
+    } else if (context->square_step == 1) {
       *dir = (direction_t) DIR_RIGHT;
-      squares_away--;
-      step++;
+      context->squares_away--;
+      context->square_step++;
     } else {
-      set_rand_dir(dir, s->way);
-      step = 0;
+      set_rand_dir(dir, s->way, &context->rng);
+      context->square_step = 0;
       s->rounds_left = 0;
     }
   } else {
-    if (step == 0) {
+    if (context->square_step == 0) {
       *dir = (direction_t) DIR_LEFT;
-      squares_away++;
-    } else if (step == 1) {
+      context->squares_away++;
+    } else if (context->square_step == 1) {
       if (s->way == CLOCKWISE) {
         *dir = (direction_t) DIR_UP;
       } else {
         *dir = (direction_t) DIR_DOWN;
       }
     } else {
-      if (squares_away > 0) {
+      if (context->squares_away > 0) {
         *dir = (direction_t) DIR_RIGHT;
-        squares_away--;
+        context->squares_away--;
       } else {
-        set_rand_dir(dir, s->way);
-        step = 0;
+        set_rand_dir(dir, s->way, &context->rng);
+        context->square_step = 0;
         s->rounds_left = 0;
       }
     }
@@ -290,163 +325,201 @@ void apply_square(direction_t *dir, Strategy *s, bool is_locked) {
 /*                              PUBLIC FUNCTIONS                              */
 /*----------------------------------------------------------------------------*/
 
+void* new_attacker_context(const void* parameters) {
+  (void) parameters; // The attacker has no parameters
+
+  struct attacker_context* context = malloc(sizeof(*context));
+  reset_attacker_context(context, 0);
+  return context;
+}
+
+void reset_attacker_context(void* attacker_context, uint64_t seed) {
+  struct attacker_context* context = attacker_context;
+
+  context->round = 1;
+
+  context->strategy_type = ZIGZAG;
+  context->max_strategy_type = ZIGZAG;
+  context->strategy = (Strategy) INIT_ZIGZAG;
+  context->way = RANDOM;
+
+  context->rounds_free = 0;
+  context->last_dir = (direction_t) DIR_STAY;
+
+  context->initial_pos = (position_t) INVALID_POSITION;
+  context->last_pos = (position_t) INVALID_POSITION;
+
+  context->already_spied = false;
+  context->rounds_since_spy = 0;
+  context->preferred_dir = (direction_t) DIR_STAY;
+
+  context->square_step = 0;
+  context->squares_away = 0;
+
+  context->rng = new_rng(seed);
+}
+
+void delete_attacker_context(void* attacker_context) {
+  free(attacker_context);
+}
+
 direction_t execute_attacker_strategy(
     position_t current_pos, Spy defender_spy) {
-  // Game
-  static int round = 1;
-
-  // Strategy
-  static StrategyType strategy_type = ZIGZAG;
-  static StrategyType max_strategy_type = ZIGZAG;
-  static Strategy strategy = INIT_ZIGZAG;
-  static Way way = RANDOM;
+  // A single context shared by every call, as only one game is played
+  static struct attacker_context context;
+  static bool is_context_initialized = false;
 
-  // Lock management
-  static int rounds_free = 0;
-  static direction_t last_dir;
+  if (!is_context_initialized) {
+    reset_attacker_context(&context, time(NULL));
+    is_context_initialized = true;
+  }
 
-  // Positions to check against current position
-  static position_t initial_pos = INVALID_POSITION;
-  static position_t last_pos = INVALID_POSITION;
+  return execute_attacker_strategy_in_context(
+      &context, current_pos, defender_spy);
+}
 
-  // Spy
-  static bool already_spied = false;
-  static int rounds_since_spy = 0;
-  static direction_t preferred_dir = DIR_STAY;
+direction_t execute_attacker_strategy_in_context(
+    void* attacker_context, position_t current_pos, Spy defender_spy) {
+  struct attacker_context* context = attacker_context;
 
   // Return value
   direction_t dir;
 
   // Things to do only in the first round
-  if (round == 1) {
-    srand(time(NULL));
-    set_pos(&initial_pos, current_pos);
+  if (context->round == 1) {
+    set_pos(&context->initial_pos, current_pos);
   }
 
   // Extract state of the game to meaningful variables
-  bool is_locked = equal_positions(current_pos, last_pos);
-  bool got_locked_recently = rounds_free < 5;
-  rounds_free = is_locked ? 0 : rounds_free + 1;
-  bool has_strategy_finished = strategy_type != ZIGZAG && strategy.rounds_left == 0;
-  bool is_time_to_spy = !already_spied && (current_pos.j == 6 || round == 30);
+  bool is_locked = equal_positions(current_pos, context->last_pos);
+  bool got_locked_recently = context->rounds_free < 5;
+  context->rounds_free = is_locked ? 0 : context->rounds_free + 1;
+  bool has_strategy_finished = context->strategy_type != ZIGZAG
+    && context->strategy.rounds_left == 0;
+  bool is_time_to_spy = !context->already_spied
+    && (current_pos.j == 6 || context->round == 30);
 
   // Spy
   if (is_time_to_spy) {
     position_t rival_pos;
     set_pos(&rival_pos, get_spy_position(defender_spy));
-    already_spied = true;
+    context->already_spied = true;
     int h_diff = (int) current_pos.j - (int) rival_pos.j;
     int v_diff = (int) current_pos.i - (int) rival_pos.i;
-    int v_displacement = (int) current_pos.i - (int) initial_pos.i;
+    int v_displacement = (int) current_pos.i - (int) context->initial_pos.i;
 
     if (abs(h_diff) + abs(v_diff) <= 6) { // We're close enough to care
       if (h_diff > 0) { // We passed
-        preferred_dir = (direction_t) DIR_RIGHT;
+        context->preferred_dir = (direction_t) DIR_RIGHT;
       } else if (h_diff == 0) { // We're passing
         if (v_diff == -1) { // We're up
-          preferred_dir = (direction_t) DIR_UP_RIGHT;
+          context->preferred_dir = (direction_t) DIR_UP_RIGHT;
         } else if (v_diff == 1) { // We're down
-          preferred_dir = (direction_t) DIR_DOWN_RIGHT;
+          context->preferred_dir = (direction_t) DIR_DOWN_RIGHT;
         } else { // We're vertically far
-          preferred_dir = (direction_t) DIR_RIGHT;
+          context->preferred_dir = (direction_t) DIR_RIGHT;
         }
       } else if (v_diff <= -2) { // We're behind and up
-        preferred_dir = (direction_t) DIR_UP_RIGHT;
+        context->preferred_dir = (direction_t) DIR_UP_RIGHT;
       } else if (v_diff == -1) { // We're behind and up
         if (abs(h_diff) <= 3) { // We're behind, up and close
-          preferred_dir = (direction_t) DIR_UP;
+          context->preferred_dir = (direction_t) DIR_UP;
         } else { // We're behind, up and far
-          preferred_dir = (direction_t) DIR_UP_RIGHT;
+          context->preferred_dir = (direction_t) DIR_UP_RIGHT;
         }
       } else if (v_diff == 0) { // We're behind and aligned
         if (abs(h_diff) <= 3) { // We're behind, aligned and close
           if (v_displacement < 0) { // We've gone up
-            preferred_dir = (direction_t) DIR_DOWN_LEFT;
+            context->preferred_dir = (direction_t) DIR_DOWN_LEFT;
           } else {  // We've gone down
-            preferred_dir = (direction_t) DIR_UP_LEFT;  
+            context->preferred_dir = (direction_t) DIR_UP_LEFT;  
           }
         } else { // We're behind, aligned and far
           if (v_displacement < 0) { // We've gone up
-            preferred_dir = (direction_t) DIR_DOWN_RIGHT;
+            context->preferred_dir = (direction_t) DIR_DOWN_RIGHT;
           } else {  // We've gone down
-            preferred_dir = (direction_t) DIR_UP_RIGHT;
+            context->preferred_dir = (direction_t) DIR_UP_RIGHT;
           }
         }
       } else if (v_diff == 1) { // We're behind and down
         if (abs(h_diff) <= 3) { // We're behind, down and close
-          preferred_dir = (direction_t) DIR_DOWN;
+          context->preferred_dir = (direction_t) DIR_DOWN;
         } else { // We're behind, down and far
-          preferred_dir = (direction_t) DIR_DOWN_RIGHT;
+          context->preferred_dir = (direction_t) DIR_DOWN_RIGHT;
         }
       } else if (v_diff >= 2) { // We're behind and down
-        preferred_dir = (direction_t) DIR_DOWN_RIGHT;
+        context->preferred_dir = (direction_t) DIR_DOWN_RIGHT;
       }
     }
   }
 
-  if (already_spied) {
+  if (context->already_spied) {
     // Expire preferred_dir sometime
-    rounds_since_spy++;
-    if (!is_same_dir(preferred_dir, (direction_t) DIR_STAY)
-        && rounds_since_spy == 2) {
-      preferred_dir = (direction_t) DIR_STAY;
+    context->rounds_since_spy++;
+    if (!is_same_dir(context->preferred_dir, (direction_t) DIR_STAY)
+        && context->rounds_since_spy == 2) {
+      context->preferred_dir = (direction_t) DIR_STAY;
     }
     // Enforce spy strategy or its expiration
-    strategy.preferred_dir = preferred_dir;
+    context->strategy.preferred_dir = context->preferred_dir;
   }
 
   // Return to the default strategy
   if (has_strategy_finished) {
-    if (strategy_type == SQUARE) {
+    if (context->strategy_type == SQUARE) {
       // Reset lock auxiliaries
       got_locked_recently = false;
-      max_strategy_type = ZIGZAG;
+      context->max_strategy_type = ZIGZAG;
     }
     // Reset strategy   
-    strategy_type = ZIGZAG;
-    strategy = (Strategy) INIT_ZIGZAG;
-    strategy.preferred_dir = preferred_dir;
-    strategy.way = way;
+    context->strategy_type = ZIGZAG;
+    context->strategy = (Strategy) INIT_ZIGZAG;
+    context->strategy.preferred_dir = context->preferred_dir;
+    context->strategy.way = context->way;
   }
   // Update strategy if we're stuck
-  else if (is_locked && strategy_type != SQUARE) {
-    update_strategy_type(&strategy_type, &max_strategy_type, got_locked_recently);
-    strategy = init_atk_strategies[strategy_type];
-    strategy.forbidden_dir = last_dir;
-    strategy.preferred_dir = preferred_dir;
-    strategy.way = way == CLOCKWISE ? COUNTERCLOCKWISE : CLOCKWISE;
+  else if (is_locked && context->strategy_type != SQUARE) {
+    update_strategy_type(&context->strategy_type,
+                         &context->max_strategy_type,
+                         got_locked_recently);
+    context->strategy = init_atk_strategies[context->strategy_type];
+    context->strategy.forbidden_dir = context->last_dir;
+    context->strategy.preferred_dir = context->preferred_dir;
+    context->strategy.way
+      = context->way == CLOCKWISE ? COUNTERCLOCKWISE : CLOCKWISE;
     // Reset is_locked to use with SQUARE strategy
     is_locked = false;
   }
 
   // Apply the appropriate strategy
-  switch (strategy_type) {
+  switch (context->strategy_type) {
     case ZIGZAG:
-      apply_zigzag(&dir, &strategy);
+      apply_zigzag(&dir, &context->strategy, &context->rng);
       break;
     case VERTICAL:
-      apply_vertical(&dir, &strategy);
+      apply_vertical(&dir, &context->strategy);
       break;
     case TRIANGLE:
-      apply_triangle(&dir, &strategy);
+      apply_triangle(&dir, &context->strategy);
       break;
     case SQUARE:
-      apply_square(&dir, &strategy, is_locked);
+      apply_square(&dir, &context->strategy, is_locked, context);
       break;
     default:
-      fprintf(stderr, "[ERROR] Strategy type %d doesn't exist.\n", strategy_type);
+      fprintf(stderr, "[ERROR] Strategy type %d doesn't exist.\n",
+          context->strategy_type);
       break;
   }
 
   // Store current position
-  set_pos(&last_pos, current_pos);
+  set_pos(&context->last_pos, current_pos);
 
   // Store current direction
-  last_dir = dir;
+  context->last_dir = dir;
 
   // Store movement way (clockwise or counterclockwise)
-  set_way(&way, dir);
+  set_way(&context->way, dir);
 
-  round++;
+  context->round++;
   return dir;
 }
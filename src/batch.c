@@ -0,0 +1,559 @@
+// Standard headers
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Internal headers
+#include "item.h"
+#include "map.h"
+#include "random.h"
+#include "spy.h"
+
+// Main header
+#include "batch.h"
+
+// Macros
+#define GAME_RUNNING 0
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+struct batch {
+  tournament_t tournament;
+  dimension_t dimension;
+  size_t number_lanes;
+
+  // Shared by all games, one bit per cell
+  uint32_t* obstacles;
+  position_t attacker_start;
+  position_t defender_start;
+
+  // Game state, one entry per lane
+  uint32_t* attacker_i;
+  uint32_t* attacker_j;
+  uint32_t* defender_i;
+  uint32_t* defender_j;
+  int32_t* direction_i;
+  int32_t* direction_j;
+  uint32_t* attacker_spy_uses;
+  uint32_t* defender_spy_uses;
+  uint8_t* status;
+  uint8_t* next_status;
+
+  // Items, spies and contexts, only used to execute the strategies
+  Item* attackers;
+  Item* defenders;
+  Spy* attacker_spies;
+  Spy* defender_spies;
+  void** attacker_contexts;
+  void** defender_contexts;
+
+  // Strategy clocks, one per lane
+  strategy_clock_t* attacker_clocks;
+  strategy_clock_t* defender_clocks;
+};
+
+/**
+ * Status of a lane: GAME_RUNNING or how the game was over.
+ */
+typedef enum {
+  ATTACKER_CHEATED = 1, DEFENDER_CHEATED, ATTACKER_ARRIVED, ATTACKER_CAPTURED,
+} LaneStatus;
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+bool set_batch_layout_from_map(Batch batch, Map map);
+void set_batch_standard_layout(Batch batch);
+void set_batch_obstacle(Batch batch, size_t cell);
+
+void reset_batch_lanes(Batch batch, size_t first_game, size_t number_games);
+
+void execute_batch_strategy(Batch batch,
+                            size_t number_games,
+                            contextual_strategy_t strategy,
+                            void** contexts,
+                            const uint32_t* player_i,
+                            const uint32_t* player_j,
+                            Spy* opponent_spies,
+                            strategy_clock_t* clocks);
+
+void move_batch_players(Batch batch,
+                        size_t number_games,
+                        uint32_t* restrict player_i,
+                        uint32_t* restrict player_j,
+                        const uint32_t* restrict opponent_i,
+                        const uint32_t* restrict opponent_j);
+
+void sync_batch_items(Item* items,
+                      size_t number_games,
+                      const uint32_t* item_i,
+                      const uint32_t* item_j);
+
+size_t update_batch_status(Batch batch,
+                           size_t number_games,
+                           size_t turn,
+                           game_result_t* results);
+
+game_result_t make_batch_result(Batch batch, size_t lane, size_t turns);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+Batch new_batch(tournament_t tournament, size_t number_lanes) {
+  assert(tournament.attacker_strategy.new_context != NULL);
+  assert(tournament.defender_strategy.new_context != NULL);
+
+  Batch batch = malloc(sizeof(*batch));
+
+  batch->tournament = tournament;
+  batch->dimension = tournament.map != NULL
+    ? get_map_dimension(tournament.map)
+    : tournament.field_dimension;
+  batch->number_lanes = number_lanes;
+
+  size_t number_cells = batch->dimension.height * batch->dimension.width;
+  batch->obstacles = calloc(number_cells / 32 + 1, sizeof(*batch->obstacles));
+
+  batch->attacker_i = malloc(number_lanes * sizeof(*batch->attacker_i));
+  batch->attacker_j = malloc(number_lanes * sizeof(*batch->attacker_j));
+  batch->defender_i = malloc(number_lanes * sizeof(*batch->defender_i));
+  batch->defender_j = malloc(number_lanes * sizeof(*batch->defender_j));
+  batch->direction_i = malloc(number_lanes * sizeof(*batch->direction_i));
+  batch->direction_j = malloc(number_lanes * sizeof(*batch->direction_j));
+  batch->attacker_spy_uses
+    = malloc(number_lanes * sizeof(*batch->attacker_spy_uses));
+  batch->defender_spy_uses
+    = malloc(number_lanes * sizeof(*batch->defender_spy_uses));
+  batch->status = malloc(number_lanes * sizeof(*batch->status));
+  batch->next_status = malloc(number_lanes * sizeof(*batch->next_status));
+
+  batch->attackers = malloc(number_lanes * sizeof(*batch->attackers));
+  batch->defenders = malloc(number_lanes * sizeof(*batch->defenders));
+  batch->attacker_spies
+    = malloc(number_lanes * sizeof(*batch->attacker_spies));
+  batch->defender_spies
+    = malloc(number_lanes * sizeof(*batch->defender_spies));
+  batch->attacker_contexts
+    = malloc(number_lanes * sizeof(*batch->attacker_contexts));
+  batch->defender_contexts
+    = malloc(number_lanes * sizeof(*batch->defender_contexts));
+  batch->attacker_clocks
+    = malloc(number_lanes * sizeof(*batch->attacker_clocks));
+  batch->defender_clocks
+    = malloc(number_lanes * sizeof(*batch->defender_clocks));
+
+  for (size_t lane = 0; lane < number_lanes; lane++) {
+    batch->attackers[lane] = new_item('A', true);
+    batch->defenders[lane] = new_item('D', true);
+    batch->attacker_spies[lane] = new_spy(batch->attackers[lane]);
+    batch->defender_spies[lane] = new_spy(batch->defenders[lane]);
+    batch->attacker_contexts[lane]
+      = tournament.attacker_strategy.new_context(
+          tournament.attacker_strategy.parameters);
+    batch->defender_contexts[lane]
+      = tournament.defender_strategy.new_context(
+          tournament.defender_strategy.parameters);
+
+    // The tournament histograms are shared, so they are never used here
+    batch->attacker_clocks[lane] = (strategy_clock_t) NULL_STRATEGY_CLOCK;
+    batch->defender_clocks[lane] = (strategy_clock_t) NULL_STRATEGY_CLOCK;
+    batch->attacker_clocks[lane].deadline = tournament.deadline;
+    batch->defender_clocks[lane].deadline = tournament.deadline;
+  }
+
+  if (tournament.map == NULL) {
+    set_batch_standard_layout(batch);
+  } else if (!set_batch_layout_from_map(batch, tournament.map)) {
+    delete_batch(batch);
+    return NULL;
+  }
+
+  return batch;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_batch(Batch batch) {
+  if (batch == NULL) return;
+
+  for (size_t lane = 0; lane < batch->number_lanes; lane++) {
+    batch->tournament.defender_strategy.delete_context(
+        batch->defender_contexts[lane]);
+    batch->tournament.attacker_strategy.delete_context(
+        batch->attacker_contexts[lane]);
+    delete_spy(batch->defender_spies[lane]);
+    delete_spy(batch->attacker_spies[lane]);
+    delete_item(batch->defenders[lane]);
+    delete_item(batch->attackers[lane]);
+  }
+
+  free(batch->defender_clocks);
+  free(batch->attacker_clocks);
+  free(batch->defender_contexts);
+  free(batch->attacker_contexts);
+  free(batch->defender_spies);
+  free(batch->attacker_spies);
+  free(batch->defenders);
+  free(batch->attackers);
+
+  free(batch->next_status);
+  free(batch->status);
+  free(batch->defender_spy_uses);
+  free(batch->attacker_spy_uses);
+  free(batch->direction_j);
+  free(batch->direction_i);
+  free(batch->defender_j);
+  free(batch->defender_i);
+  free(batch->attacker_j);
+  free(batch->attacker_i);
+
+  free(batch->obstacles);
+
+  free(batch);
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_batch_number_lanes(Batch batch) {
+  if (batch == NULL) return 0;
+  return batch->number_lanes;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_batch_latency_histograms(Batch batch,
+                                  Histogram attacker_latencies,
+                                  Histogram defender_latencies) {
+  if (batch == NULL) return;
+
+  for (size_t lane = 0; lane < batch->number_lanes; lane++) {
+    batch->attacker_clocks[lane].latencies = attacker_latencies;
+    batch->defender_clocks[lane].latencies = defender_latencies;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void play_batch(Batch batch,
+                size_t first_game,
+                size_t number_games,
+                game_result_t* results) {
+  if (batch == NULL) return;
+
+  assert(number_games <= batch->number_lanes);
+
+  reset_batch_lanes(batch, first_game, number_games);
+
+  size_t games_running = number_games;
+  size_t max_turns = batch->tournament.max_turns;
+
+  for (size_t turn = 0; turn < max_turns && games_running > 0; turn++) {
+    // The attacker spies the defender where it was before this turn
+    sync_batch_items(batch->defenders, number_games,
+                     batch->defender_i, batch->defender_j);
+
+    execute_batch_strategy(batch, number_games,
+                           batch->tournament.attacker_strategy,
+                           batch->attacker_contexts,
+                           batch->attacker_i, batch->attacker_j,
+                           batch->defender_spies,
+                           batch->attacker_clocks);
+
+    move_batch_players(batch, number_games,
+                       batch->attacker_i, batch->attacker_j,
+                       batch->defender_i, batch->defender_j);
+
+    // The defender spies the attacker after it moved
+    sync_batch_items(batch->attackers, number_games,
+                     batch->attacker_i, batch->attacker_j);
+
+    execute_batch_strategy(batch, number_games,
+                           batch->tournament.defender_strategy,
+                           batch->defender_contexts,
+                           batch->defender_i, batch->defender_j,
+                           batch->attacker_spies,
+                           batch->defender_clocks);
+
+    move_batch_players(batch, number_games,
+                       batch->defender_i, batch->defender_j,
+                       batch->attacker_i, batch->attacker_j);
+
+    games_running -= update_batch_status(batch, number_games, turn, results);
+  }
+
+  // A draw happens only if nobody wins before max_turns
+  for (size_t lane = 0; lane < number_games; lane++) {
+    if (batch->status[lane] == GAME_RUNNING) {
+      results[lane] = make_batch_result(batch, lane, max_turns);
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+bool set_batch_layout_from_map(Batch batch, Map map) {
+  size_t attacker_occurrences = 0;
+  size_t defender_occurrences = 0;
+
+  dimension_t dimension = batch->dimension;
+  for (size_t i = 0; i < dimension.height; i++) {
+    for (size_t j = 0; j < dimension.width; j++) {
+      position_t position = { i, j };
+      char symbol = get_map_symbol(map, position);
+
+      if (symbol == 'X') {
+        set_batch_obstacle(batch, i * dimension.width + j);
+      } else if (symbol == 'A') {
+        batch->attacker_start = position;
+        attacker_occurrences++;
+      } else if (symbol == 'D') {
+        batch->defender_start = position;
+        defender_occurrences++;
+      }
+    }
+  }
+
+  if (attacker_occurrences != 1 || defender_occurrences != 1) {
+    fprintf(stderr, "ERROR: Map must have exactly one attacker "
+        "and one defender to be played in a batch\n");
+    return false;
+  }
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_batch_standard_layout(Batch batch) {
+  dimension_t dimension = batch->dimension;
+
+  batch->attacker_start = (position_t) { dimension.height / 2, 1 };
+  batch->defender_start
+    = (position_t) { dimension.height / 2, dimension.width - 2 };
+
+  for (size_t i = 0; i < dimension.height; i++) {
+    for (size_t j = 0; j < dimension.width; j++) {
+      bool is_border = i == 0 || i == dimension.height - 1
+        || j == 0 || j == dimension.width - 1;
+      if (is_border) set_batch_obstacle(batch, i * dimension.width + j);
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_batch_obstacle(Batch batch, size_t cell) {
+  batch->obstacles[cell / 32] |= 1U << (cell % 32);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void reset_batch_lanes(Batch batch, size_t first_game, size_t number_games) {
+  tournament_t* tournament = &batch->tournament;
+
+  for (size_t lane = 0; lane < number_games; lane++) {
+    batch->attacker_i[lane] = batch->attacker_start.i;
+    batch->attacker_j[lane] = batch->attacker_start.j;
+    batch->defender_i[lane] = batch->defender_start.i;
+    batch->defender_j[lane] = batch->defender_start.j;
+    batch->attacker_spy_uses[lane] = 0;
+    batch->defender_spy_uses[lane] = 0;
+    batch->status[lane] = GAME_RUNNING;
+
+    batch->attacker_clocks[lane].last_direction = (direction_t) DIR_STAY;
+    batch->attacker_clocks[lane].timeouts = 0;
+    batch->defender_clocks[lane].last_direction = (direction_t) DIR_STAY;
+    batch->defender_clocks[lane].timeouts = 0;
+
+    reset_spy(batch->attacker_spies[lane]);
+    reset_spy(batch->defender_spies[lane]);
+
+    // Same seeds as seed_game() in a tournament
+    uint64_t seed = mix_seed(tournament->seed, first_game + lane);
+    tournament->attacker_strategy.reset_context(
+        batch->attacker_contexts[lane], mix_seed(seed, 0));
+    tournament->defender_strategy.reset_context(
+        batch->defender_contexts[lane], mix_seed(seed, 1));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Strategies are scalar state machines, so they are executed lane by lane
+void execute_batch_strategy(Batch batch,
+                            size_t number_games,
+                            contextual_strategy_t strategy,
+                            void** contexts,
+                            const uint32_t* player_i,
+                            const uint32_t* player_j,
+                            Spy* opponent_spies,
+                            strategy_clock_t* clocks) {
+  for (size_t lane = 0; lane < number_games; lane++) {
+    if (batch->status[lane] != GAME_RUNNING) continue;
+
+    position_t position = { player_i[lane], player_j[lane] };
+    direction_t direction = execute_clocked_strategy(
+        strategy, contexts[lane], position, opponent_spies[lane],
+        &clocks[lane]);
+
+    batch->direction_i[lane] = direction.i;
+    batch->direction_j[lane] = direction.j;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Same rules as move_item_in_field(), without branches so that the
+// compiler can vectorize the loop
+void move_batch_players(Batch batch,
+                        size_t number_games,
+                        uint32_t* restrict player_i,
+                        uint32_t* restrict player_j,
+                        const uint32_t* restrict opponent_i,
+                        const uint32_t* restrict opponent_j) {
+  const uint32_t* restrict obstacles = batch->obstacles;
+  const uint8_t* restrict status = batch->status;
+  const int32_t* restrict direction_i = batch->direction_i;
+  const int32_t* restrict direction_j = batch->direction_j;
+
+  uint32_t height = batch->dimension.height;
+  uint32_t width = batch->dimension.width;
+
+  for (size_t lane = 0; lane < number_games; lane++) {
+    // Negative coordinates wrap around and fall beyond the limits
+    uint32_t new_i = player_i[lane] + (uint32_t) direction_i[lane];
+    uint32_t new_j = player_j[lane] + (uint32_t) direction_j[lane];
+
+    // Bitwise operators instead of && and || avoid branches
+    uint32_t is_inside = (new_i < height) & (new_j < width);
+    uint32_t cell = (new_i * width + new_j) & -is_inside;
+
+    uint32_t is_blocked = (is_inside ^ 1)
+      | ((obstacles[cell / 32] >> (cell % 32)) & 1)
+      | ((new_i == opponent_i[lane]) & (new_j == opponent_j[lane]))
+      | (status[lane] != GAME_RUNNING);
+
+    player_i[lane] = is_blocked ? player_i[lane] : new_i;
+    player_j[lane] = is_blocked ? player_j[lane] : new_j;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void sync_batch_items(Item* items,
+                      size_t number_games,
+                      const uint32_t* item_i,
+                      const uint32_t* item_j) {
+  for (size_t lane = 0; lane < number_games; lane++) {
+    set_item_position(items[lane], (position_t) { item_i[lane], item_j[lane] });
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Same checks, in the same order, as play_game()
+size_t update_batch_status(Batch batch,
+                           size_t number_games,
+                           size_t turn,
+                           game_result_t* results) {
+  for (size_t lane = 0; lane < number_games; lane++) {
+    // The defender spy is used by the attacker and vice-versa
+    batch->attacker_spy_uses[lane]
+      = get_spy_number_uses(batch->defender_spies[lane]);
+    batch->defender_spy_uses[lane]
+      = get_spy_number_uses(batch->attacker_spies[lane]);
+  }
+
+  const uint32_t* restrict attacker_i = batch->attacker_i;
+  const uint32_t* restrict attacker_j = batch->attacker_j;
+  const uint32_t* restrict defender_i = batch->defender_i;
+  const uint32_t* restrict defender_j = batch->defender_j;
+  const uint32_t* restrict attacker_spy_uses = batch->attacker_spy_uses;
+  const uint32_t* restrict defender_spy_uses = batch->defender_spy_uses;
+  uint8_t* restrict next_status = batch->next_status;
+
+  uint32_t max_number_spies = batch->tournament.max_number_spies;
+  uint32_t goal_column = batch->dimension.width - 2;
+
+  for (size_t lane = 0; lane < number_games; lane++) {
+    // Same (asymmetric) rule as neighbor_positions(attacker, defender)
+    uint32_t is_captured = (defender_i[lane] >= attacker_i[lane] - 1)
+      & (defender_i[lane] <= attacker_i[lane] + 1)
+      & (defender_j[lane] >= attacker_i[lane] - 1)
+      & (defender_j[lane] <= attacker_j[lane] + 1);
+
+    // Checks are applied from the last to the first one,
+    // so that the first one that holds takes precedence
+    uint8_t lane_status = GAME_RUNNING;
+    lane_status = is_captured ? ATTACKER_CAPTURED : lane_status;
+    lane_status = attacker_j[lane] == goal_column
+      ? ATTACKER_ARRIVED : lane_status;
+    lane_status = defender_spy_uses[lane] > max_number_spies
+      ? DEFENDER_CHEATED : lane_status;
+    lane_status = attacker_spy_uses[lane] > max_number_spies
+      ? ATTACKER_CHEATED : lane_status;
+
+    next_status[lane] = lane_status;
+  }
+
+  // Only games that were over in this turn have their results stored
+  size_t games_over = 0;
+  for (size_t lane = 0; lane < number_games; lane++) {
+    if (batch->status[lane] != GAME_RUNNING) continue;
+    if (next_status[lane] == GAME_RUNNING) continue;
+
+    batch->status[lane] = next_status[lane];
+    results[lane] = make_batch_result(batch, lane, turn+1);
+    games_over++;
+  }
+
+  return games_over;
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_result_t make_batch_result(Batch batch, size_t lane, size_t turns) {
+  game_result_t result = NULL_GAME_RESULT;
+
+  switch (batch->status[lane]) {
+    case ATTACKER_CHEATED:
+      result.winner = WINNER_DEFENDER;
+      result.reason = REASON_CHEATING;
+      break;
+    case DEFENDER_CHEATED:
+      result.winner = WINNER_ATTACKER;
+      result.reason = REASON_CHEATING;
+      break;
+    case ATTACKER_ARRIVED:
+      result.winner = WINNER_ATTACKER;
+      result.reason = REASON_GOAL;
+      break;
+    case ATTACKER_CAPTURED:
+      result.winner = WINNER_DEFENDER;
+      result.reason = REASON_CAPTURE;
+      break;
+    default:
+      result.winner = WINNER_NONE;
+      result.reason = REASON_DRAW;
+      break;
+  }
+
+  result.turns = turns;
+  result.attacker_spy_uses = batch->attacker_spy_uses[lane];
+  result.defender_spy_uses = batch->defender_spy_uses[lane];
+  result.attacker_timeouts = batch->attacker_clocks[lane].timeouts;
+  result.defender_timeouts = batch->defender_clocks[lane].timeouts;
+
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
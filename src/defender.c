@@ -2,9 +2,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+// Header to get time seed
+#include <time.h>
+
 // Internal headers
 #include "direction.h"
 #include "position.h"
+#include "random.h"
 #include "spy.h"
 
 // Main header
@@ -36,6 +40,35 @@ const Strategy init_def_strategies[] = {
   INIT_STAY, INIT_ALIGN, INIT_LESS, INIT_FORWARD
 };
 
+/*----------------------------------------------------------------------------*/
+/*                                  CONTEXT                                   */
+/*----------------------------------------------------------------------------*/
+
+struct defender_context {
+  // Game
+  int round;
+
+  // Strategy
+  StrategyType strategy_type;
+  Strategy strategy;
+
+  // Lock management
+  direction_t last_dir;
+
+  // Positions to check against current position
+  position_t initial_pos;
+  position_t last_pos;
+
+  // Spy
+  position_t rival_pos;
+  bool already_spied;
+  int align_retries;
+  bool aligned;
+
+  // Random numbers
+  rng_t rng;
+};
+
 /*----------------------------------------------------------------------------*/
 /*                                    UTIL                                    */
 /*----------------------------------------------------------------------------*/
@@ -100,123 +133,160 @@ void apply_forward(direction_t *dir, Strategy *s) {
 /*                              PUBLIC FUNCTIONS                              */
 /*----------------------------------------------------------------------------*/
 
+void* new_defender_context(const void* parameters) {
+  (void) parameters; // The defender has no parameters
+
+  struct defender_context* context = malloc(sizeof(*context));
+  reset_defender_context(context, 0);
+  return context;
+}
+
+void reset_defender_context(void* defender_context, uint64_t seed) {
+  struct defender_context* context = defender_context;
+
+  context->round = 1;
+
+  context->strategy_type = STAY;
+  context->strategy = (Strategy) INIT_STAY;
+
+  context->last_dir = (direction_t) DIR_STAY;
+
+  context->initial_pos = (position_t) INVALID_POSITION;
+  context->last_pos = (position_t) INVALID_POSITION;
+
+  context->rival_pos = (position_t) { 0, 0 };
+  context->already_spied = false;
+  context->align_retries = 2;
+  context->aligned = false;
+
+  context->rng = new_rng(seed);
+}
+
+void delete_defender_context(void* defender_context) {
+  free(defender_context);
+}
+
 direction_t execute_defender_strategy(
     position_t current_pos, Spy attacker_spy) {
-  // Game
-  static int round = 1;
+  // A single context shared by every call, as only one game is played
+  static struct defender_context context;
+  static bool is_context_initialized = false;
 
-  // Strategy
-  static StrategyType strategy_type = STAY;
-  static Strategy strategy = INIT_STAY;
-
-  // Lock management
-  static direction_t last_dir;
+  if (!is_context_initialized) {
+    reset_defender_context(&context, mix_seed(time(NULL), 1));
+    is_context_initialized = true;
+  }
 
-  // Positions to check against current position
-  static position_t initial_pos = INVALID_POSITION;
-  static position_t last_pos = INVALID_POSITION;
+  return execute_defender_strategy_in_context(
+      &context, current_pos, attacker_spy);
+}
 
-  // Spy
-  static position_t rival_pos;
-  static bool already_spied = false;
-  static int align_retries = 2;
-  static bool aligned = false;
+direction_t execute_defender_strategy_in_context(
+    void* defender_context, position_t current_pos, Spy attacker_spy) {
+  struct defender_context* context = defender_context;
 
   // Return value
   direction_t dir;
 
   // Things to do only in the first round
-  if (round == 1) {
-    set_pos(&initial_pos, current_pos);
+  if (context->round == 1) {
+    set_pos(&context->initial_pos, current_pos);
   }
 
   // Extract state of the game to meaningful variables
-  bool is_locked = strategy_type != STAY && equal_positions(current_pos, last_pos);
-  bool has_strategy_finished = strategy.rounds_left == 0;
-  bool is_time_to_spy = !already_spied && round == 6;
-  if (!aligned) {
-    aligned = (int) current_pos.i - (int) rival_pos.i == 0;
+  bool is_locked = context->strategy_type != STAY
+    && equal_positions(current_pos, context->last_pos);
+  bool has_strategy_finished = context->strategy.rounds_left == 0;
+  bool is_time_to_spy = !context->already_spied && context->round == 6;
+  if (!context->aligned) {
+    context->aligned = (int) current_pos.i - (int) context->rival_pos.i == 0;
   }
-  bool retry_align = strategy_type == FORWARD && align_retries > 0 && !aligned;
+  bool retry_align = context->strategy_type == FORWARD
+    && context->align_retries > 0 && !context->aligned;
 
   // Spy
   if (is_time_to_spy) {
-    set_pos(&rival_pos, get_spy_position(attacker_spy));
-    already_spied = true;
-    int v_diff = (int) current_pos.i - (int) rival_pos.i;
+    set_pos(&context->rival_pos, get_spy_position(attacker_spy));
+    context->already_spied = true;
+    int v_diff = (int) current_pos.i - (int) context->rival_pos.i;
 
     // Set new strategy
     if (v_diff != 0) { // Need to align
-      strategy_type = ALIGN;
-      strategy = (Strategy) INIT_ALIGN;
-      strategy.rounds_left = abs(v_diff);
-      strategy.dir = v_diff < 0 ? (direction_t) DIR_DOWN : (direction_t) DIR_UP;
+      context->strategy_type = ALIGN;
+      context->strategy = (Strategy) INIT_ALIGN;
+      context->strategy.rounds_left = abs(v_diff);
+      context->strategy.dir
+        = v_diff < 0 ? (direction_t) DIR_DOWN : (direction_t) DIR_UP;
     } else { // Pass through ALIGN
-      strategy_type = LESS;
-      strategy = (Strategy) INIT_LESS;
-      strategy.dir = rand() % 2 == 0 ? (direction_t) DIR_UP : (direction_t) DIR_DOWN;
+      context->strategy_type = LESS;
+      context->strategy = (Strategy) INIT_LESS;
+      context->strategy.dir = next_rng_int(&context->rng) % 2 == 0
+        ? (direction_t) DIR_UP : (direction_t) DIR_DOWN;
     }
   }
 
   if (has_strategy_finished) {
     if (retry_align) {
-      int v_diff = (int) current_pos.i - (int) rival_pos.i;
-      align_retries--;
-      strategy_type = ALIGN;
-      strategy = (Strategy) INIT_ALIGN;
-      strategy.rounds_left = abs(v_diff);
-      strategy.dir = v_diff < 0 ? (direction_t) DIR_DOWN : (direction_t) DIR_UP;
+      int v_diff = (int) current_pos.i - (int) context->rival_pos.i;
+      context->align_retries--;
+      context->strategy_type = ALIGN;
+      context->strategy = (Strategy) INIT_ALIGN;
+      context->strategy.rounds_left = abs(v_diff);
+      context->strategy.dir
+        = v_diff < 0 ? (direction_t) DIR_DOWN : (direction_t) DIR_UP;
     } else {
-      strategy_type = LESS;
-      strategy = (Strategy) INIT_LESS;
-      strategy.dir = rand() % 2 == 0 ? (direction_t) DIR_UP : (direction_t) DIR_DOWN;
+      context->strategy_type = LESS;
+      context->strategy = (Strategy) INIT_LESS;
+      context->strategy.dir = next_rng_int(&context->rng) % 2 == 0
+        ? (direction_t) DIR_UP : (direction_t) DIR_DOWN;
     }
   }
   // Update strategy if we're stuck
   else if (is_locked) {
-    if (rand() % 2 == 0) {
-      strategy_type = FORWARD;
-      strategy = (Strategy) INIT_FORWARD;
+    if (next_rng_int(&context->rng) % 2 == 0) {
+      context->strategy_type = FORWARD;
+      context->strategy = (Strategy) INIT_FORWARD;
     } else {
-      strategy_type = ALIGN;
-      strategy = (Strategy) INIT_ALIGN;
-      strategy.rounds_left = 2;
-      if (is_same_dir(last_dir, (direction_t) DIR_UP)
-          || is_same_dir(last_dir, (direction_t) DIR_UP_RIGHT)
-          || is_same_dir(last_dir, (direction_t) DIR_UP_LEFT)) {
-        strategy.dir = (direction_t) DIR_DOWN;
+      context->strategy_type = ALIGN;
+      context->strategy = (Strategy) INIT_ALIGN;
+      context->strategy.rounds_left = 2;
+      if (is_same_dir(context->last_dir, (direction_t) DIR_UP)
+          || is_same_dir(context->last_dir, (direction_t) DIR_UP_RIGHT)
+          || is_same_dir(context->last_dir, (direction_t) DIR_UP_LEFT)) {
+        context->strategy.dir = (direction_t) DIR_DOWN;
       } else {
-        strategy.dir = (direction_t) DIR_UP;
+        context->strategy.dir = (direction_t) DIR_UP;
       }
     }
   }
 
   // Apply the appropriate strategy
-  switch (strategy_type) {
+  switch (context->strategy_type) {
     case STAY:
       apply_stay(&dir);
       break;
     case ALIGN:
-      apply_align(&dir, &strategy);
+      apply_align(&dir, &context->strategy);
       break;
     case LESS:
-      apply_less(&dir, &strategy);
+      apply_less(&dir, &context->strategy);
       break;
     case FORWARD:
-      apply_forward(&dir, &strategy);
+      apply_forward(&dir, &context->strategy);
       break;
     default:
-      fprintf(stderr, "[ERROR] Strategy type %d doesn't exist.\n", strategy_type);
+      fprintf(stderr, "[ERROR] Strategy type %d doesn't exist.\n",
+          context->strategy_type);
       break;
   }
 
   // Store current position
-  set_pos(&last_pos, current_pos);
+  set_pos(&context->last_pos, current_pos);
 
   // Store current direction
-  last_dir = dir;
+  context->last_dir = dir;
 
-  round++;
+  context->round++;
   return dir;
 }
 
@@ -0,0 +1,257 @@
+// Standard headers
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Internal headers
+#include "dimension.h"
+#include "layout.h"
+#include "map.h"
+#include "position.h"
+
+// Main header
+#include "distance_field.h"
+
+// Macros
+#define OBSTACLE_SYMBOL 'X'
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+struct distance_field {
+  dimension_t dimension;
+  uint32_t max_distance;
+
+  // Distances, allocated together with the distance field and tiled when
+  // the field is large. Obstacles are marked as unreachable before the
+  // search
+  GridLayout layout;
+  size_t tiles_per_row;
+  uint32_t distances[];
+};
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+DistanceField allocate_distance_field(dimension_t dimension,
+                                      GridLayout layout);
+GridLayout get_default_distance_layout(dimension_t dimension);
+size_t get_distance_index(DistanceField distance_field, size_t i, size_t j);
+bool search_goal_distances(DistanceField distance_field);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+DistanceField new_distance_field(Map map) {
+  if (map == NULL) return NULL;
+
+  dimension_t dimension = get_map_dimension(map);
+  DistanceField distance_field = allocate_distance_field(
+      dimension, get_default_distance_layout(dimension));
+  if (distance_field == NULL) return NULL;
+
+  for (size_t i = 0; i < dimension.height; i++) {
+    for (size_t j = 0; j < dimension.width; j++) {
+      bool is_obstacle
+        = get_map_symbol(map, (position_t) { i, j }) == OBSTACLE_SYMBOL;
+      if (is_obstacle) {
+        distance_field->distances[get_distance_index(distance_field, i, j)]
+          = UNREACHABLE_DISTANCE;
+      }
+    }
+  }
+
+  if (!search_goal_distances(distance_field)) {
+    delete_distance_field(distance_field);
+    return NULL;
+  }
+
+  return distance_field;
+}
+
+/*----------------------------------------------------------------------------*/
+
+DistanceField new_bordered_distance_field(dimension_t dimension) {
+  return new_bordered_distance_field_with_layout(
+      dimension, get_default_distance_layout(dimension));
+}
+
+/*----------------------------------------------------------------------------*/
+
+DistanceField new_bordered_distance_field_with_layout(dimension_t dimension,
+                                                      GridLayout layout) {
+  DistanceField distance_field = allocate_distance_field(dimension, layout);
+  if (distance_field == NULL) return NULL;
+
+  for (size_t i = 0; i < dimension.height; i++) {
+    for (size_t j = 0; j < dimension.width; j++) {
+      bool is_border = i == 0 || j == 0
+        || i == dimension.height-1 || j == dimension.width-1;
+      if (is_border) {
+        distance_field->distances[get_distance_index(distance_field, i, j)]
+          = UNREACHABLE_DISTANCE;
+      }
+    }
+  }
+
+  if (!search_goal_distances(distance_field)) {
+    delete_distance_field(distance_field);
+    return NULL;
+  }
+
+  return distance_field;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_distance_field(DistanceField distance_field) {
+  if (distance_field == NULL) return;
+
+  distance_field->dimension = (dimension_t) NULL_DIMENSION;
+  free(distance_field);
+}
+
+/*----------------------------------------------------------------------------*/
+
+dimension_t get_distance_field_dimension(DistanceField distance_field) {
+  if (distance_field == NULL) return (dimension_t) NULL_DIMENSION;
+  return distance_field->dimension;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint32_t get_goal_distance(DistanceField distance_field, position_t position) {
+  if (distance_field == NULL) return UNREACHABLE_DISTANCE;
+
+  dimension_t dimension = distance_field->dimension;
+  if (position.i >= dimension.height || position.j >= dimension.width) {
+    return UNREACHABLE_DISTANCE;
+  }
+
+  size_t index = get_distance_index(distance_field, position.i, position.j);
+  return distance_field->distances[index];
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint32_t get_max_goal_distance(DistanceField distance_field) {
+  if (distance_field == NULL) return 0;
+  return distance_field->max_distance;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+// Distances start at zero, to be marked as obstacles by the caller
+DistanceField allocate_distance_field(dimension_t dimension,
+                                      GridLayout layout) {
+  if (dimension.width < 2) return NULL;
+
+  size_t number_cells = LAYOUT_NUMBER_CELLS(layout, dimension);
+
+  DistanceField distance_field = calloc(
+      1, sizeof(*distance_field) + number_cells * sizeof(uint32_t));
+  if (distance_field == NULL) return NULL;
+
+  distance_field->dimension = dimension;
+  distance_field->max_distance = 0;
+  distance_field->layout = layout;
+  distance_field->tiles_per_row = TILES_PER_LINE(dimension.width);
+
+  return distance_field;
+}
+
+/*----------------------------------------------------------------------------*/
+
+GridLayout get_default_distance_layout(dimension_t dimension) {
+  size_t number_cells = dimension.height * dimension.width;
+  return number_cells >= TILED_LAYOUT_MIN_CELLS
+    ? LAYOUT_TILED
+    : LAYOUT_ROW_MAJOR;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_distance_index(DistanceField distance_field, size_t i, size_t j) {
+  if (distance_field->layout == LAYOUT_ROW_MAJOR) {
+    return i * distance_field->dimension.width + j;
+  }
+
+  return TILED_INDEX(i, j, distance_field->tiles_per_row);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Breadth-first search from every free cell of the goal column at once.
+// Cells not visited yet are zero, and visited cells keep their distance
+// plus one until the search ends, so zero is never a valid mark. The
+// queue holds row-major positions, whatever the layout of the distances.
+// Padding cells of tiled distances are never visited, so they end up
+// unreachable. Fails only if the queue cannot be allocated
+bool search_goal_distances(DistanceField distance_field) {
+  dimension_t dimension = distance_field->dimension;
+  size_t number_cells = dimension.height * dimension.width;
+  uint32_t* distances = distance_field->distances;
+
+  size_t* queue = malloc(number_cells * sizeof(*queue));
+  if (queue == NULL) return false;
+
+  size_t head = 0, tail = 0;
+
+  size_t goal_column = dimension.width - 2;
+  for (size_t i = 0; i < dimension.height; i++) {
+    size_t index = get_distance_index(distance_field, i, goal_column);
+    if (distances[index] == UNREACHABLE_DISTANCE) continue;
+
+    distances[index] = 1;
+    queue[tail++] = i * dimension.width + goal_column;
+  }
+
+  while (head < tail) {
+    size_t position = queue[head++];
+    size_t i = position / dimension.width;
+    size_t j = position % dimension.width;
+    uint32_t distance = distances[get_distance_index(distance_field, i, j)];
+
+    for (int di = -1; di <= 1; di++) {
+      for (int dj = -1; dj <= 1; dj++) {
+        // Unsigned positions out of the field wrap around to large values
+        size_t ni = i + di;
+        size_t nj = j + dj;
+        if (ni >= dimension.height || nj >= dimension.width) continue;
+
+        size_t neighbor = get_distance_index(distance_field, ni, nj);
+        if (distances[neighbor] != 0) continue;
+
+        distances[neighbor] = distance + 1;
+        queue[tail++] = ni * dimension.width + nj;
+      }
+    }
+  }
+
+  free(queue);
+
+  number_cells = LAYOUT_NUMBER_CELLS(distance_field->layout, dimension);
+  for (size_t index = 0; index < number_cells; index++) {
+    if (distances[index] == UNREACHABLE_DISTANCE) continue;
+
+    if (distances[index] == 0) {
+      distances[index] = UNREACHABLE_DISTANCE;
+      continue;
+    }
+
+    distances[index]--;
+    if (distances[index] > distance_field->max_distance) {
+      distance_field->max_distance = distances[index];
+    }
+  }
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
@@ -2,8 +2,14 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+// Internal headers
+#include "arena.h"
+#include "layout.h"
 
 // Main header
 #include "field.h"
@@ -12,44 +18,146 @@
 /*                        PRIVATE STRUCT IMPLEMENTATION                       */
 /*----------------------------------------------------------------------------*/
 
+/**
+ * A cell stores the code of the item placed on it, or EMPTY_CELL.
+ * Codes index the slots of the field, with the item, its symbol and its
+ * position, and are given to items in the order they are first added.
+ */
+typedef unsigned char cell_t;
+
+#define EMPTY_CELL 0
+
+/**
+ * The first slots are stored in the field itself, and the others are
+ * allocated only once the field has more items, so the state of a field
+ * with few items is not much larger than its grid.
+ */
+struct item_slot {
+  Item item;
+  position_t position;
+  char symbol;
+};
+typedef struct item_slot item_slot_t;
+
+#define INLINE_SLOTS 8 // With the slot of EMPTY_CELL
+#define EXTRA_SLOTS (FIELD_MAX_ITEMS + 1 - INLINE_SLOTS)
+
+/**
+ * Small fields store one bitboard per item, with one bit per cell in
+ * row-major order, and an occupancy bitboard with all of them combined.
+ * Huge fields are sparse: their cells are split in chunks of consecutive
+ * cells, allocated only once an item is added to one of their cells.
+ * Other fields, or small fields with too many items, use the grid.
+ */
+typedef enum {
+  GRID_BACKEND, BITBOARD_BACKEND, SPARSE_BACKEND,
+} FieldBackend;
+
+#define BITBOARD_WORDS 2
+#define BITBOARD_MAX_CELLS (64 * BITBOARD_WORDS)
+#define BITBOARD_MAX_ITEMS 7
+
+#define SPARSE_MIN_CELLS (1UL << 26) // Cells of a 64 MiB grid
+#define CHUNK_CELLS 4096
+
 struct field {
   dimension_t dimension;
-  Item** grid;
+  FieldBackend backend;
+
+  size_t number_items;
+  item_slot_t slots[INLINE_SLOTS];
+  item_slot_t* extra_slots;
+
+  // Bitboards, indexed by item code
+  uint64_t occupancy[BITBOARD_WORDS];
+  uint64_t boards[BITBOARD_MAX_ITEMS + 1][BITBOARD_WORDS];
+
+  // Chunks of sparse fields, or NULL where all cells are empty. They and
+  // the extra slots come from the arena of the field, if it has one, and
+  // are kept until the field is deleted. Cells of the border are not
+  // stored: they have the border code, if it is not EMPTY_CELL
+  Arena arena;
+  cell_t** chunks;
+  size_t number_chunks;
+  cell_t border_code;
+
+  // Grid, allocated together with the field. Large grids are tiled,
+  // while bitboards and sparse fields are always row-major
+  GridLayout layout;
+  size_t tiles_per_row;
+  cell_t grid[];
 };
 
 /*----------------------------------------------------------------------------*/
 /*                          PRIVATE FUNCTIONS HEADERS                         */
 /*----------------------------------------------------------------------------*/
 
-Item** allocate_field_grid(dimension_t dimension);
-void free_field_grid(Item** grid, dimension_t dimension);
+bool is_valid_field_dimension(dimension_t dimension);
+void* allocate_field_memory(Arena arena, size_t size);
+Field copy_field(Arena arena,
+                 Field field,
+                 const Item* originals,
+                 const Item* clones,
+                 size_t number_items);
+FieldBackend choose_field_backend(dimension_t dimension);
+GridLayout get_default_field_layout(dimension_t dimension);
+GridLayout choose_field_layout(dimension_t dimension, GridLayout layout);
+size_t get_field_size(dimension_t dimension, GridLayout layout);
+void init_field(Field field,
+                dimension_t dimension,
+                GridLayout layout,
+                Arena arena);
+
+size_t get_cell_index(Field field, position_t position);
+cell_t get_cell_code(Field field, size_t index);
+bool set_cell_code(Field field, size_t index, cell_t code);
+bool move_cell_code(Field field, size_t from, size_t to, cell_t code);
+bool is_cell_empty(Field field, size_t index);
+
+item_slot_t* get_item_slot(Field field, cell_t code);
+cell_t find_item_code(Field field, Item item);
+cell_t register_item_in_field(Field field, Item item);
+void switch_to_grid_backend(Field field);
+
+cell_t get_sparse_cell_code(Field field, size_t index);
+bool set_sparse_cell_code(Field field, size_t index, cell_t code);
+bool is_border_index(Field field, size_t index);
 
 bool position_is_beyond_limit_of_field(Field field, position_t p);
-void print_item_in_field(Item item);
 
 /*----------------------------------------------------------------------------*/
 /*                              PUBLIC FUNCTIONS                              */
 /*----------------------------------------------------------------------------*/
 
 Field new_field(dimension_t dimension) {
-  if (dimension.height < FIELD_MIN_DIMENSION.height) {
-    fprintf(stderr,
-        "Height must be at least %ld because of the Field's borders\n",
-        FIELD_MIN_DIMENSION.height);
-    return NULL;
-  }
+  return new_field_with_layout(dimension, get_default_field_layout(dimension));
+}
 
-  if (dimension.width < FIELD_MIN_DIMENSION.width) {
-    fprintf(stderr,
-        "Width must be at least %ld because of the Field's borders\n",
-        FIELD_MIN_DIMENSION.width);
-    return NULL;
-  }
+/*----------------------------------------------------------------------------*/
 
-  Field field = malloc(sizeof(*field));
+Field new_field_with_layout(dimension_t dimension, GridLayout layout) {
+  if (!is_valid_field_dimension(dimension)) return NULL;
 
-  field->dimension = dimension;
-  field->grid = allocate_field_grid(dimension);
+  layout = choose_field_layout(dimension, layout);
+
+  Field field = malloc(get_field_size(dimension, layout));
+  init_field(field, dimension, layout, NULL);
+
+  return field;
+}
+
+/*----------------------------------------------------------------------------*/
+
+Field new_field_in_arena(Arena arena, dimension_t dimension) {
+  if (arena == NULL || !is_valid_field_dimension(dimension)) return NULL;
+
+  GridLayout layout =
+    choose_field_layout(dimension, get_default_field_layout(dimension));
+
+  Field field = allocate_from_arena(arena, get_field_size(dimension, layout));
+  if (field == NULL) return NULL;
+
+  init_field(field, dimension, layout, arena);
 
   return field;
 }
@@ -59,9 +167,18 @@ Field new_field(dimension_t dimension) {
 void delete_field(Field field) {
   if (field == NULL) return;
 
-  free_field_grid(field->grid, field->dimension);
-  field->grid = NULL;
+  if (field->chunks != NULL && field->arena == NULL) {
+    for (size_t k = 0; k < field->number_chunks; k++) {
+      free(field->chunks[k]);
+    }
+    free(field->chunks);
+  }
+  field->chunks = NULL;
+
+  if (field->arena == NULL) free(field->extra_slots);
+  field->extra_slots = NULL;
 
+  field->number_items = 0;
   field->dimension = (dimension_t) NULL_DIMENSION;
 
   free(field);
@@ -86,18 +203,50 @@ void print_field_info(Field field) {
 
 /*----------------------------------------------------------------------------*/
 
-void print_field_grid(Field field) {
-  if (field == NULL) return;
+size_t get_field_grid_length(Field field) {
+  if (field == NULL) return 0;
+
+  // Each row has a border before every cell, another one and a newline,
+  // and the grid is followed by an empty line
+  return field->dimension.height * (2 * field->dimension.width + 2) + 1;
+}
 
+/*----------------------------------------------------------------------------*/
+
+size_t write_field_grid(Field field, char* buffer) {
+  if (field == NULL) return 0;
+
+  char* cursor = buffer;
+
+  // Cells of row-major grids are read in order
+  size_t index = 0;
   for (size_t i = 0; i < field->dimension.height; i++) {
-    for (size_t j = 0; j < field->dimension.width; j++) {
-      putchar('|');
-      print_item_in_field(field->grid[i][j]);
+    for (size_t j = 0; j < field->dimension.width; j++, index++) {
+      size_t cell_index = field->layout == LAYOUT_ROW_MAJOR
+        ? index
+        : get_cell_index(field, (position_t) { i, j });
+
+      *cursor++ = '|';
+      *cursor++ = get_item_slot(field, get_cell_code(field, cell_index))
+        ->symbol;
     }
-    putchar('|');
-    putchar('\n');
+    *cursor++ = '|';
+    *cursor++ = '\n';
   }
-  putchar('\n');
+  *cursor++ = '\n';
+
+  return cursor - buffer;
+}
+
+/*----------------------------------------------------------------------------*/
+
+Item get_field_item(Field field, position_t position) {
+  if (field == NULL || position_is_beyond_limit_of_field(field, position)) {
+    return NULL;
+  }
+
+  cell_t code = get_cell_code(field, get_cell_index(field, position));
+  return get_item_slot(field, code)->item;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -111,7 +260,16 @@ void add_item_to_field(Field field, Item item, position_t position) {
     return;
   }
 
-  field->grid[position.i][position.j] = item;
+  cell_t code = find_item_code(field, item);
+  if (code == EMPTY_CELL) code = register_item_in_field(field, item);
+  if (code == EMPTY_CELL) return;
+
+  if (!set_cell_code(field, get_cell_index(field, position), code)) {
+    fprintf(stderr, "ERROR: Could not allocate the cells of the field\n");
+    return;
+  }
+
+  get_item_slot(field, code)->position = position;
   set_item_position(item, position);
 }
 
@@ -120,7 +278,11 @@ void add_item_to_field(Field field, Item item, position_t position) {
 void move_item_in_field(Field field, Item item, direction_t direction) {
   if (field == NULL || item == NULL) return;
 
-  position_t item_position = get_item_position(item);
+  cell_t code = find_item_code(field, item);
+  if (code == EMPTY_CELL) return;
+
+  item_slot_t* slot = get_item_slot(field, code);
+  position_t item_position = slot->position;
 
   // Given how items are added to the field, their position
   // should never be beyond the limits of the field
@@ -131,66 +293,499 @@ void move_item_in_field(Field field, Item item, direction_t direction) {
     return;
   }
 
-  position_t new_position = move_position(get_item_position(item), direction);
+  position_t new_position = move_position(item_position, direction);
+
+  // Maps may not have borders, so items could try to leave the field
+  if (position_is_beyond_limit_of_field(field, new_position)) return;
+
+  size_t new_index = get_cell_index(field, new_position);
 
   // Item cannot be moved if position is already occupied
-  if (field->grid[new_position.i][new_position.j] != NULL) return;
+  if (!is_cell_empty(field, new_index)) return;
 
-  // Change current position in the grid
-  field->grid[new_position.i][new_position.j] = item;
-  field->grid[item_position.i][item_position.j] = NULL;
+  // Change current position in the grid, unless the cells of sparse
+  // fields where it would move cannot be allocated
+  size_t index = get_cell_index(field, item_position);
+  if (!move_cell_code(field, index, new_index, code)) return;
+  slot->position = new_position;
   set_item_position(item, new_position);
 }
 
 /*----------------------------------------------------------------------------*/
-/*                             PRIVATE FUNCTIONS                              */
+
+void remove_item_from_field(Field field, Item item) {
+  if (field == NULL || item == NULL) return;
+
+  cell_t code = find_item_code(field, item);
+  if (code == EMPTY_CELL) return;
+
+  item_slot_t* slot = get_item_slot(field, code);
+  if (position_is_beyond_limit_of_field(field, slot->position)) return;
+
+  set_cell_code(field, get_cell_index(field, slot->position), EMPTY_CELL);
+  slot->position = (position_t) INVALID_POSITION;
+}
+
 /*----------------------------------------------------------------------------*/
 
-// Allocate field's grid as C-matrix in the heap
-Item** allocate_field_grid(dimension_t dimension) {
-  Item** grid = malloc(dimension.height * sizeof(*grid));
-  for (size_t i = 0; i < dimension.height; i++) {
-    grid[i] = malloc(dimension.width * sizeof(*grid[i]));
-    for (size_t j = 0; j < dimension.width; j++) {
-      grid[i][j] = NULL;
+// The border is added in the same order as cell by cell, so the item
+// is left in the last cell, the bottom right corner
+void add_border_to_field(Field field, Item item) {
+  if (field == NULL || item == NULL) return;
+
+  size_t height = field->dimension.height;
+  size_t width = field->dimension.width;
+
+  if (field->backend != SPARSE_BACKEND) {
+    for (size_t i = 0; i < height; i++) {
+      add_item_to_field(field, item, (position_t) { i, 0 });
     }
+    for (size_t i = 0; i < height; i++) {
+      add_item_to_field(field, item, (position_t) { i, width-1 });
+    }
+    for (size_t j = 0; j < width; j++) {
+      add_item_to_field(field, item, (position_t) { 0, j });
+    }
+    for (size_t j = 0; j < width; j++) {
+      add_item_to_field(field, item, (position_t) { height-1, j });
+    }
+    return;
   }
 
-  return grid;
+  cell_t code = find_item_code(field, item);
+  if (code == EMPTY_CELL) code = register_item_in_field(field, item);
+  if (code == EMPTY_CELL) return;
+
+  position_t corner = { height-1, width-1 };
+  field->border_code = code;
+  get_item_slot(field, code)->position = corner;
+  set_item_position(item, corner);
+}
+
+/*----------------------------------------------------------------------------*/
+
+Field clone_field(Field field,
+                  const Item* originals,
+                  const Item* clones,
+                  size_t number_items) {
+  if (field == NULL) return NULL;
+  return copy_field(NULL, field, originals, clones, number_items);
+}
+
+/*----------------------------------------------------------------------------*/
+
+Field clone_field_in_arena(Arena arena,
+                           Field field,
+                           const Item* originals,
+                           const Item* clones,
+                           size_t number_items) {
+  if (arena == NULL || field == NULL) return NULL;
+  return copy_field(arena, field, originals, clones, number_items);
 }
 
 /*----------------------------------------------------------------------------*/
 
-// Free field's grid as C-matrix in the heap
-void free_field_grid(Item** grid, dimension_t dimension) {
-  // This function should always be used on an initialized field,
-  // whose grid was allocated previously
-  assert(grid != NULL);
+size_t get_field_memory_size(Field field) {
+  if (field == NULL) return 0;
+  return get_field_size(field->dimension, field->layout);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+bool is_valid_field_dimension(dimension_t dimension) {
+  if (dimension.height < FIELD_MIN_DIMENSION.height) {
+    fprintf(stderr,
+        "Height must be at least %ld because of the Field's borders\n",
+        FIELD_MIN_DIMENSION.height);
+    return false;
+  }
 
-  for (size_t i = 0; i < dimension.height; i++) {
-    free(grid[i]);
-    grid[i] = NULL;
+  if (dimension.width < FIELD_MIN_DIMENSION.width) {
+    fprintf(stderr,
+        "Width must be at least %ld because of the Field's borders\n",
+        FIELD_MIN_DIMENSION.width);
+    return false;
   }
-  free(grid);
-  grid = NULL;
+
+  return true;
 }
 
 /*----------------------------------------------------------------------------*/
 
-bool position_is_beyond_limit_of_field(Field field, position_t p) {
-  if (field == NULL) return false;
-  return p.i > field->dimension.height-1 || p.j > field->dimension.width-1;
+void* allocate_field_memory(Arena arena, size_t size) {
+  return arena != NULL ? allocate_from_arena(arena, size) : malloc(size);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Copies own their chunks and extra slots, taken from the arena given,
+// which may not be the one of the field. Copies outside an arena are
+// deleted as soon as any of their memory cannot be allocated.
+Field copy_field(Arena arena,
+                 Field field,
+                 const Item* originals,
+                 const Item* clones,
+                 size_t number_items) {
+  size_t field_size = get_field_size(field->dimension, field->layout);
+
+  Field clone = allocate_field_memory(arena, field_size);
+  if (clone == NULL) return NULL;
+  memcpy(clone, field, field_size);
+
+  clone->arena = arena;
+  clone->chunks = NULL;
+  clone->extra_slots = NULL;
+
+  bool is_copied = true;
+
+  if (field->extra_slots != NULL) {
+    size_t extra_size = EXTRA_SLOTS * sizeof(item_slot_t);
+    clone->extra_slots = allocate_field_memory(arena, extra_size);
+    is_copied = clone->extra_slots != NULL;
+    if (is_copied) {
+      memcpy(clone->extra_slots, field->extra_slots, extra_size);
+    }
+  }
+
+  if (is_copied && field->backend == SPARSE_BACKEND) {
+    size_t directory_size = field->number_chunks * sizeof(*clone->chunks);
+    clone->chunks = allocate_field_memory(arena, directory_size);
+    is_copied = clone->chunks != NULL;
+    if (is_copied) memset(clone->chunks, 0, directory_size);
+
+    for (size_t k = 0; is_copied && k < field->number_chunks; k++) {
+      if (field->chunks[k] == NULL) continue;
+
+      size_t chunk_size = CHUNK_CELLS * sizeof(cell_t);
+      clone->chunks[k] = allocate_field_memory(arena, chunk_size);
+      is_copied = clone->chunks[k] != NULL;
+      if (is_copied) memcpy(clone->chunks[k], field->chunks[k], chunk_size);
+    }
+  }
+
+  if (!is_copied) {
+    if (arena == NULL) delete_field(clone);
+    return NULL;
+  }
+
+  for (size_t k = 0; k < number_items; k++) {
+    cell_t code = find_item_code(field, originals[k]);
+    if (code == EMPTY_CELL) continue;
+
+    item_slot_t* slot = get_item_slot(clone, code);
+    slot->item = clones[k];
+    set_item_position(clones[k], slot->position);
+    set_item_field_code(clones[k], code);
+  }
+
+  return clone;
+}
+
+/*----------------------------------------------------------------------------*/
+
+FieldBackend choose_field_backend(dimension_t dimension) {
+  size_t number_cells = dimension.height * dimension.width;
+
+  if (number_cells <= BITBOARD_MAX_CELLS) return BITBOARD_BACKEND;
+  if (number_cells >= SPARSE_MIN_CELLS) return SPARSE_BACKEND;
+  return GRID_BACKEND;
+}
+
+/*----------------------------------------------------------------------------*/
+
+GridLayout get_default_field_layout(dimension_t dimension) {
+  size_t number_cells = dimension.height * dimension.width;
+  return number_cells >= TILED_LAYOUT_MIN_CELLS
+    ? LAYOUT_TILED
+    : LAYOUT_ROW_MAJOR;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Only fields that use the grid from the start may be tiled, as
+// bitboards are copied to the grid in the same order
+GridLayout choose_field_layout(dimension_t dimension, GridLayout layout) {
+  if (choose_field_backend(dimension) != GRID_BACKEND) return LAYOUT_ROW_MAJOR;
+  return layout;
 }
 
 /*----------------------------------------------------------------------------*/
 
-void print_item_in_field(Item item) {
-  if (item == NULL) {
-    putchar(' ');
+// Sparse fields have no grid
+size_t get_field_size(dimension_t dimension, GridLayout layout) {
+  if (choose_field_backend(dimension) == SPARSE_BACKEND) {
+    return sizeof(struct field);
+  }
+
+  size_t number_cells = LAYOUT_NUMBER_CELLS(layout, dimension);
+  return sizeof(struct field) + number_cells * sizeof(cell_t);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void init_field(Field field,
+                dimension_t dimension,
+                GridLayout layout,
+                Arena arena) {
+  size_t number_cells = dimension.height * dimension.width;
+
+  field->dimension = dimension;
+  field->layout = layout;
+  field->tiles_per_row = TILES_PER_LINE(dimension.width);
+  field->backend = choose_field_backend(dimension);
+
+  field->number_items = 0;
+  field->slots[EMPTY_CELL] = (item_slot_t) {
+    .item = NULL,
+    .position = INVALID_POSITION,
+    .symbol = ' ',
+  };
+  field->extra_slots = NULL;
+
+  memset(field->occupancy, 0, sizeof(field->occupancy));
+  memset(field->boards, 0, sizeof(field->boards));
+
+  field->arena = arena;
+  field->chunks = NULL;
+  field->number_chunks = 0;
+  field->border_code = EMPTY_CELL;
+
+  if (field->backend != SPARSE_BACKEND) {
+    memset(field->grid, EMPTY_CELL,
+           LAYOUT_NUMBER_CELLS(layout, dimension) * sizeof(cell_t));
     return;
   }
 
-  putchar(get_item_symbol(item));
+  field->number_chunks = (number_cells + CHUNK_CELLS - 1) / CHUNK_CELLS;
+  size_t directory_size = field->number_chunks * sizeof(*field->chunks);
+
+  if (arena != NULL) {
+    field->chunks = allocate_from_arena(arena, directory_size);
+    memset(field->chunks, 0, directory_size);
+  } else {
+    field->chunks = calloc(field->number_chunks, sizeof(*field->chunks));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_cell_index(Field field, position_t position) {
+  if (field->layout == LAYOUT_ROW_MAJOR) {
+    return position.i * field->dimension.width + position.j;
+  }
+
+  return TILED_INDEX(position.i, position.j, field->tiles_per_row);
+}
+
+/*----------------------------------------------------------------------------*/
+
+cell_t get_cell_code(Field field, size_t index) {
+  if (field->backend == GRID_BACKEND) return field->grid[index];
+  if (field->backend == SPARSE_BACKEND) {
+    return get_sparse_cell_code(field, index);
+  }
+
+  uint64_t bit = 1ULL << (index % 64);
+  if ((field->occupancy[index / 64] & bit) == 0) return EMPTY_CELL;
+
+  for (size_t code = 1; code <= field->number_items; code++) {
+    if (field->boards[code][index / 64] & bit) return code;
+  }
+
+  return EMPTY_CELL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Only sparse fields may fail, when the chunk of the cell cannot be
+// allocated
+bool set_cell_code(Field field, size_t index, cell_t code) {
+  if (field->backend == GRID_BACKEND) {
+    field->grid[index] = code;
+    return true;
+  }
+
+  if (field->backend == SPARSE_BACKEND) {
+    return set_sparse_cell_code(field, index, code);
+  }
+
+  uint64_t bit = 1ULL << (index % 64);
+
+  // The cell may have another item, which is replaced
+  for (size_t other = 1; other <= field->number_items; other++) {
+    field->boards[other][index / 64] &= ~bit;
+  }
+  field->occupancy[index / 64] &= ~bit;
+
+  if (code == EMPTY_CELL) return true;
+
+  field->boards[code][index / 64] |= bit;
+  field->occupancy[index / 64] |= bit;
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Moves an item from a cell to an empty cell, and leaves it where it
+// is if the cell cannot be set
+bool move_cell_code(Field field, size_t from, size_t to, cell_t code) {
+  if (field->backend == GRID_BACKEND) {
+    field->grid[to] = code;
+    field->grid[from] = EMPTY_CELL;
+    return true;
+  }
+
+  if (field->backend == SPARSE_BACKEND) {
+    if (!set_sparse_cell_code(field, to, code)) return false;
+    return set_sparse_cell_code(field, from, EMPTY_CELL);
+  }
+
+  uint64_t from_bit = 1ULL << (from % 64);
+  uint64_t to_bit = 1ULL << (to % 64);
+
+  field->boards[code][from / 64] &= ~from_bit;
+  field->occupancy[from / 64] &= ~from_bit;
+  field->boards[code][to / 64] |= to_bit;
+  field->occupancy[to / 64] |= to_bit;
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool is_cell_empty(Field field, size_t index) {
+  if (field->backend == GRID_BACKEND) return field->grid[index] == EMPTY_CELL;
+  if (field->backend == SPARSE_BACKEND) {
+    return get_sparse_cell_code(field, index) == EMPTY_CELL;
+  }
+  return (field->occupancy[index / 64] & (1ULL << (index % 64))) == 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+item_slot_t* get_item_slot(Field field, cell_t code) {
+  return code < INLINE_SLOTS
+    ? &field->slots[code]
+    : &field->extra_slots[code - INLINE_SLOTS];
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Items keep their code, so they are found at once in the field where
+// they were last added. Items added to many fields may have another
+// code in this one, or none, and are searched.
+cell_t find_item_code(Field field, Item item) {
+  size_t item_code = get_item_field_code(item);
+  if (item_code != EMPTY_CELL && item_code <= field->number_items
+      && get_item_slot(field, item_code)->item == item) {
+    return item_code;
+  }
+
+  for (size_t code = 1; code <= field->number_items; code++) {
+    if (get_item_slot(field, code)->item == item) return code;
+  }
+
+  return EMPTY_CELL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+cell_t register_item_in_field(Field field, Item item) {
+  if (field->number_items == FIELD_MAX_ITEMS) {
+    fprintf(stderr, "ERROR: Field cannot have more than %d items!\n",
+        FIELD_MAX_ITEMS);
+    return EMPTY_CELL;
+  }
+
+  if (field->backend == BITBOARD_BACKEND
+      && field->number_items == BITBOARD_MAX_ITEMS) {
+    switch_to_grid_backend(field);
+  }
+
+  if (field->number_items + 1 == INLINE_SLOTS) {
+    size_t extra_size = EXTRA_SLOTS * sizeof(item_slot_t);
+    field->extra_slots = field->arena != NULL
+      ? allocate_from_arena(field->arena, extra_size)
+      : malloc(extra_size);
+
+    if (field->extra_slots == NULL) {
+      fprintf(stderr, "ERROR: Could not allocate the items of the field\n");
+      return EMPTY_CELL;
+    }
+  }
+
+  cell_t code = ++field->number_items;
+  *get_item_slot(field, code) = (item_slot_t) {
+    .item = item,
+    .position = INVALID_POSITION,
+    .symbol = get_item_symbol(item),
+  };
+  set_item_field_code(item, code);
+
+  return code;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Copies the bitboards to the grid, which is used from then on
+void switch_to_grid_backend(Field field) {
+  size_t number_cells = field->dimension.height * field->dimension.width;
+  for (size_t index = 0; index < number_cells; index++) {
+    field->grid[index] = get_cell_code(field, index);
+  }
+
+  field->backend = GRID_BACKEND;
+}
+
+/*----------------------------------------------------------------------------*/
+
+cell_t get_sparse_cell_code(Field field, size_t index) {
+  if (field->border_code != EMPTY_CELL && is_border_index(field, index)) {
+    return field->border_code;
+  }
+
+  const cell_t* chunk = field->chunks[index / CHUNK_CELLS];
+  return chunk != NULL ? chunk[index % CHUNK_CELLS] : EMPTY_CELL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Chunks are allocated when an item is first added to one of their cells
+bool set_sparse_cell_code(Field field, size_t index, cell_t code) {
+  cell_t** chunk = &field->chunks[index / CHUNK_CELLS];
+
+  if (*chunk == NULL) {
+    if (code == EMPTY_CELL) return true;
+
+    size_t chunk_size = CHUNK_CELLS * sizeof(cell_t);
+    *chunk = allocate_field_memory(field->arena, chunk_size);
+    if (*chunk == NULL) return false;
+    memset(*chunk, EMPTY_CELL, chunk_size);
+  }
+
+  (*chunk)[index % CHUNK_CELLS] = code;
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool is_border_index(Field field, size_t index) {
+  size_t width = field->dimension.width;
+  size_t number_cells = field->dimension.height * width;
+  size_t j = index % width;
+
+  return index < width || index >= number_cells - width
+    || j == 0 || j == width-1;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool position_is_beyond_limit_of_field(Field field, position_t p) {
+  if (field == NULL) return false;
+  return p.i > field->dimension.height-1 || p.j > field->dimension.width-1;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1,13 +1,25 @@
 // Standard headers
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 // Internal headers
+#include "arena.h"
+#include "async_renderer.h"
+#include "attacker.h"
+#include "defender.h"
 #include "field.h"
+#include "histogram.h"
 #include "map.h"
+#include "random.h"
+#include "renderer.h"
+#include "replay.h"
 #include "spy.h"
+#include "timer.h"
 
 // Main header
 #include "game.h"
@@ -16,6 +28,82 @@
 #define MAX_SINGLE_OCCURRENCE 1UL
 #define UNUSED(x) (void)(x) // Auxiliary to avoid error of unused parameter
 
+#define CLONE_ARENA_SLACK 512 // Room for the items and spies of a clone
+
+#define STANDARD_FIELD_HEIGHT 10
+#define STANDARD_FIELD_WIDTH 10
+
+// Borders are the only obstacles of standard fields. Positions beyond
+// the field wrap around to large values, and are borders too
+#define IS_STANDARD_FIELD_BORDER(position, height, width) \
+  ((position).i == 0 || (position).j == 0 \
+   || (position).i >= (height)-1 || (position).j >= (width)-1)
+
+// Defines a play loop for games in a standard field of the given
+// dimension, with the given strategies. Both are constants, so the
+// strategies are called directly (and may be inlined with LTO) and the
+// borders are checked against constants. Players are moved, spy on each
+// other and end the game exactly as in run_game(), but the field is only
+// updated once the game is over
+#define DEFINE_SPECIALIZED_GAME(name, execute_attacker, execute_defender, \
+                                height, width) \
+  game_result_t name(Game game, size_t max_turns) { \
+    position_t attacker = get_item_position(game->attacker); \
+    position_t defender = get_item_position(game->defender); \
+    \
+    game_result_t result; \
+    for (size_t turn = 0; turn < max_turns; turn++) { \
+      direction_t direction = execute_attacker( \
+          game->attacker_context, attacker, game->defender_spy); \
+      game->attacker_clock.last_direction = direction; \
+      \
+      position_t target = move_position(attacker, direction); \
+      if (!IS_STANDARD_FIELD_BORDER(target, height, width) \
+          && !equal_positions(target, defender)) { \
+        attacker = target; \
+        set_item_position(game->attacker, attacker); \
+      } \
+      \
+      direction = execute_defender( \
+          game->defender_context, defender, game->attacker_spy); \
+      game->defender_clock.last_direction = direction; \
+      \
+      target = move_position(defender, direction); \
+      if (!IS_STANDARD_FIELD_BORDER(target, height, width) \
+          && !equal_positions(target, attacker)) { \
+        defender = target; \
+        set_item_position(game->defender, defender); \
+      } \
+      \
+      bool is_over = true; \
+      if (has_spy_exceeded_max_number_uses( \
+            game->defender_spy, game->max_number_spies)) { \
+        result = make_game_result( \
+            game, WINNER_DEFENDER, REASON_CHEATING, turn+1); \
+      } else if (has_spy_exceeded_max_number_uses( \
+            game->attacker_spy, game->max_number_spies)) { \
+        result = make_game_result( \
+            game, WINNER_ATTACKER, REASON_CHEATING, turn+1); \
+      } else if (attacker.j == (width)-2) { \
+        result = make_game_result( \
+            game, WINNER_ATTACKER, REASON_GOAL, turn+1); \
+      } else if (neighbor_positions(attacker, defender)) { \
+        result = make_game_result( \
+            game, WINNER_DEFENDER, REASON_CAPTURE, turn+1); \
+      } else { \
+        is_over = false; \
+      } \
+      \
+      if (is_over) { \
+        update_players_in_field(game); \
+        return result; \
+      } \
+    } \
+    \
+    update_players_in_field(game); \
+    return make_game_result(game, WINNER_NONE, REASON_DRAW, max_turns); \
+  }
+
 /*----------------------------------------------------------------------------*/
 /*                        PRIVATE STRUCT IMPLEMENTATION                       */
 /*----------------------------------------------------------------------------*/
@@ -23,8 +111,30 @@
 struct game {
   Field field;
 
+  // Games of a pool live in its arena and are only freed with it,
+  // and released ones wait in the pool until they are acquired again.
+  // Clones own an arena with all their memory, freed with them.
+  Arena arena;
+  bool is_released;
+  bool owns_arena;
+
+  // Where the game starts, restored by reset_game()
+  game_snapshot_t start;
+
+  // Games without a map are played in a standard field, whose only
+  // obstacles are its borders
+  bool is_standard_field;
+
   size_t max_number_spies;
 
+  contextual_strategy_t attacker_strategy;
+  contextual_strategy_t defender_strategy;
+
+  void* attacker_context;
+  void* defender_context;
+
+  // Plain strategies are executed as contextual strategies
+  // whose context points to these function pointers
   PlayerStrategy execute_attacker_strategy;
   PlayerStrategy execute_defender_strategy;
 
@@ -34,21 +144,113 @@ struct game {
 
   Spy attacker_spy;
   Spy defender_spy;
+
+  // Time the strategy calls, applying the deadline of the game
+  strategy_clock_t attacker_clock;
+  strategy_clock_t defender_clock;
+
+  // Notified of the events of the game, with a spare slot
+  // for the printer of play_game()
+  size_t number_observers;
+  game_observer_t observers[GAME_MAX_OBSERVERS + 1];
+
+  // How play_game() draws the field every turn, and whether it is drawn
+  // by another thread, which may skip frames to not slow the game down
+  RenderMode render_mode;
+  bool is_rendering_async;
+  bool is_dropping_frames;
+
+  // Draws the field for print_game(), created when it is first called
+  // and reused, so printing a game does not allocate a frame each time
+  Renderer grid_renderer;
+};
+
+/**
+ * A specialized game binds the strategies and the dimension of a standard
+ * field at compile time, and has a play loop for them only.
+ */
+struct specialized_game {
+  direction_t (*execute_attacker_strategy)(void*, position_t, Spy);
+  direction_t (*execute_defender_strategy)(void*, position_t, Spy);
+  dimension_t field_dimension;
+  game_result_t (*run)(Game game, size_t max_turns);
+};
+typedef struct specialized_game specialized_game_t;
+
+/**
+ * A game pool creates its games in its arena and keeps the released ones
+ * in a stack, from where they are acquired again.
+ */
+struct game_pool {
+  Arena arena;
+
+  Map map;
+  dimension_t field_dimension;
+  size_t max_number_spies;
+  contextual_strategy_t attacker_strategy;
+  contextual_strategy_t defender_strategy;
+
+  // All games created by the pool, and the released ones
+  Game* games;
+  size_t number_games;
+  Game* released_games;
+  size_t number_released_games;
+  size_t capacity;
 };
 
+/**
+ * The printer is the observer used by play_game() to draw the field
+ * every turn and print the result once the game is over.
+ */
+struct game_printer {
+  Renderer renderer;
+  AsyncRenderer async_renderer;
+};
+typedef struct game_printer game_printer_t;
+
+// The standard games of the tournaments, played with the classic strategies
+game_result_t run_standard_game(Game game, size_t max_turns);
+
+static const specialized_game_t specialized_games[] = {
+  {
+    execute_attacker_strategy_in_context,
+    execute_defender_strategy_in_context,
+    { STANDARD_FIELD_HEIGHT, STANDARD_FIELD_WIDTH },
+    run_standard_game,
+  },
+};
+
+// Absolute time when the strategy call running in this thread is late,
+// or zero if it has no deadline
+static _Thread_local uint64_t strategy_deadline_time = 0;
+
 /*----------------------------------------------------------------------------*/
 /*                          PRIVATE FUNCTIONS HEADERS                         */
 /*----------------------------------------------------------------------------*/
 
 Game allocate_game(
+  Arena arena,
+  size_t max_number_spies,
+  contextual_strategy_t attacker_strategy,
+  contextual_strategy_t defender_strategy);
+
+Game new_game_in_arena(
+  Arena arena,
+  Map map,
   dimension_t field_dimension,
   size_t max_number_spies,
-  PlayerStrategy execute_attacker_strategy,
-  PlayerStrategy execute_defender_strategy);
+  contextual_strategy_t attacker_strategy,
+  contextual_strategy_t defender_strategy);
+
+void clear_game_settings(Game game);
+
+contextual_strategy_t make_plain_strategy_contextual();
+direction_t execute_plain_strategy(void* context,
+                                   position_t position,
+                                   Spy opponent_spy);
 
-bool has_map_exceeded_max_occurrences_of_symbol(
-    Map map, char symbol, size_t max_occurrences);
 void set_item_in_field_from_map(Field field, Item item, Map map);
+void set_single_item_in_field_from_map(Field field, Item item, Map map);
 
 void set_attacker_in_field(Field field, Item attacker);
 void set_defender_in_field(Field field, Item defender);
@@ -59,10 +261,43 @@ bool has_spy_exceeded_max_number_uses(Spy opponent_spy,
 bool has_defender_captured_attacker(Item defender, Item attacker);
 bool has_attacker_arrived_end_field(Field field, Item attacker);
 
-void move_item(Field field,
-               Item item,
-               Spy opponent_spy,
-               PlayerStrategy execute_item_strategy);
+replay_move_t move_item(Field field,
+                        Item item,
+                        Spy opponent_spy,
+                        contextual_strategy_t item_strategy,
+                        void* item_context,
+                        strategy_clock_t* item_clock);
+
+game_result_t run_game(Game game, size_t max_turns);
+const specialized_game_t* find_specialized_game(Game game);
+void update_players_in_field(Game game);
+game_result_t make_game_result(Game game,
+                               Winner winner,
+                               GameOverReason reason,
+                               size_t turns);
+
+void notify_game_start(Game game);
+void notify_turn_end(Game game,
+                     size_t turn,
+                     replay_move_t attacker_move,
+                     replay_move_t defender_move);
+void notify_game_end(Game game, game_result_t result);
+
+void record_observed_turn(void* replay,
+                          Game game,
+                          size_t turn,
+                          replay_move_t attacker_move,
+                          replay_move_t defender_move);
+
+game_observer_t make_printer_observer(game_printer_t* printer);
+void start_printing_game(void* printer, Game game);
+void print_turn(void* printer,
+                Game game,
+                size_t turn,
+                replay_move_t attacker_move,
+                replay_move_t defender_move);
+void print_game_end(void* printer, Game game, game_result_t result);
+void render_turn(game_printer_t* printer, Field field, size_t turn);
 
 /*----------------------------------------------------------------------------*/
 /*                              PUBLIC FUNCTIONS                              */
@@ -73,15 +308,14 @@ Game new_game(
     size_t max_number_spies,
     PlayerStrategy execute_attacker_strategy,
     PlayerStrategy execute_defender_strategy) {
-  Game game = allocate_game(
+  Game game = new_contextual_game(
       field_dimension,
       max_number_spies,
-      execute_attacker_strategy,
-      execute_defender_strategy);
+      make_plain_strategy_contextual(),
+      make_plain_strategy_contextual());
 
-  set_attacker_in_field(game->field, game->attacker);
-  set_defender_in_field(game->field, game->defender);
-  set_obstacles_in_field(game->field, game->obstacle);
+  game->execute_attacker_strategy = execute_attacker_strategy;
+  game->execute_defender_strategy = execute_defender_strategy;
 
   return game;
 }
@@ -93,37 +327,52 @@ Game new_game_from_map(
     size_t max_number_spies,
     PlayerStrategy execute_attacker_strategy,
     PlayerStrategy execute_defender_strategy) {
-  if (map == NULL) return NULL;
+  Game game = new_contextual_game_from_map(
+      map,
+      max_number_spies,
+      make_plain_strategy_contextual(),
+      make_plain_strategy_contextual());
 
-  dimension_t field_dimension = get_map_dimension(map);
+  if (game == NULL) return NULL;
 
-  Game game = allocate_game(
+  game->execute_attacker_strategy = execute_attacker_strategy;
+  game->execute_defender_strategy = execute_defender_strategy;
+
+  return game;
+}
+
+/*----------------------------------------------------------------------------*/
+
+Game new_contextual_game(
+    dimension_t field_dimension,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy) {
+  return new_game_in_arena(
+      NULL,
+      NULL,
       field_dimension,
       max_number_spies,
-      execute_attacker_strategy,
-      execute_defender_strategy);
-
-  if (has_map_exceeded_max_occurrences_of_symbol(
-        map, get_item_symbol(game->attacker), MAX_SINGLE_OCCURRENCE)) {
-    fprintf(stderr, "ERROR: Map exceeded max occurrences of symbol %c\n",
-        get_item_symbol(game->attacker));
-    delete_game(game);
-    return NULL;
-  }
+      attacker_strategy,
+      defender_strategy);
+}
 
-  if (has_map_exceeded_max_occurrences_of_symbol(
-        map, get_item_symbol(game->defender), MAX_SINGLE_OCCURRENCE)) {
-    fprintf(stderr, "ERROR: Map exceeded max occurrences of symbol %c\n",
-        get_item_symbol(game->defender));
-    delete_game(game);
-    return NULL;
-  }
+/*----------------------------------------------------------------------------*/
 
-  set_item_in_field_from_map(game->field, game->attacker, map);
-  set_item_in_field_from_map(game->field, game->defender, map);
-  set_item_in_field_from_map(game->field, game->obstacle, map);
+Game new_contextual_game_from_map(
+    Map map,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy) {
+  if (map == NULL) return NULL;
 
-  return game;
+  return new_game_in_arena(
+      NULL,
+      map,
+      get_map_dimension(map),
+      max_number_spies,
+      attacker_strategy,
+      defender_strategy);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -131,6 +380,26 @@ Game new_game_from_map(
 void delete_game(Game game) {
   if (game == NULL) return;
 
+  if (game->defender_strategy.delete_context != NULL) {
+    game->defender_strategy.delete_context(game->defender_context);
+  }
+  game->defender_context = NULL;
+
+  if (game->attacker_strategy.delete_context != NULL) {
+    game->attacker_strategy.delete_context(game->attacker_context);
+  }
+  game->attacker_context = NULL;
+
+  delete_renderer(game->grid_renderer);
+  game->grid_renderer = NULL;
+
+  // Everything else of pooled games is freed with the arena of the pool,
+  // and of clones with their own arena
+  if (game->arena != NULL) {
+    if (game->owns_arena) delete_arena(game->arena);
+    return;
+  }
+
   delete_spy(game->defender_spy);
   game->defender_spy = NULL;
 
@@ -159,64 +428,488 @@ void delete_game(Game game) {
 
 /*----------------------------------------------------------------------------*/
 
-void print_game(Game game) {
+// Everything of a clone but the contexts of its strategies comes from an
+// arena of its own, whose first block fits the game, its items, its spies
+// and the copy of the field, so cloning allocates little more than once
+Game clone_game(Game game) {
+  if (game == NULL) return NULL;
+
+  Arena arena = new_arena(sizeof(*game) + CLONE_ARENA_SLACK
+                          + get_field_memory_size(game->field));
+
+  Game clone = allocate_game(
+      arena,
+      game->max_number_spies,
+      game->attacker_strategy,
+      game->defender_strategy);
+  if (clone == NULL) {
+    delete_arena(arena);
+    return NULL;
+  }
+  clone->owns_arena = true;
+
+  clone->execute_attacker_strategy = game->execute_attacker_strategy;
+  clone->execute_defender_strategy = game->execute_defender_strategy;
+
+  Item originals[] = { game->attacker, game->defender, game->obstacle };
+  Item clones[] = { clone->attacker, clone->defender, clone->obstacle };
+
+  clone->field = clone_field_in_arena(arena, game->field,
+                                      originals, clones, 3);
+  if (clone->field == NULL) {
+    delete_game(clone);
+    return NULL;
+  }
+
+  clone->start = game->start;
+  clone->is_standard_field = game->is_standard_field;
+
+  clone->attacker_clock = game->attacker_clock;
+  clone->defender_clock = game->defender_clock;
+  clone->attacker_clock.latencies = NULL;
+  clone->defender_clock.latencies = NULL;
+
+  set_spy_number_uses(clone->attacker_spy,
+                      get_spy_number_uses(game->attacker_spy));
+  set_spy_number_uses(clone->defender_spy,
+                      get_spy_number_uses(game->defender_spy));
+
+  clone->render_mode = game->render_mode;
+  clone->is_rendering_async = game->is_rendering_async;
+  clone->is_dropping_frames = game->is_dropping_frames;
+
+  return clone;
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_snapshot_t snapshot_game(Game game) {
+  if (game == NULL) return (game_snapshot_t) { 0 };
+
+  game_snapshot_t snapshot = {
+    .attacker_position = get_item_position(game->attacker),
+    .defender_position = get_item_position(game->defender),
+    .attacker_spy_uses = get_spy_number_uses(game->attacker_spy),
+    .defender_spy_uses = get_spy_number_uses(game->defender_spy),
+    .attacker_timeouts = game->attacker_clock.timeouts,
+    .defender_timeouts = game->defender_clock.timeouts,
+    .attacker_last_direction = game->attacker_clock.last_direction,
+    .defender_last_direction = game->defender_clock.last_direction,
+  };
+
+  return snapshot;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Both players leave the field before any of them comes back,
+// so they can be restored to each other's positions
+void restore_game(Game game, game_snapshot_t snapshot) {
   if (game == NULL) return;
 
-  print_field_grid(game->field);
+  remove_item_from_field(game->field, game->attacker);
+  remove_item_from_field(game->field, game->defender);
+  add_item_to_field(game->field, game->attacker, snapshot.attacker_position);
+  add_item_to_field(game->field, game->defender, snapshot.defender_position);
+
+  set_spy_number_uses(game->attacker_spy, snapshot.attacker_spy_uses);
+  set_spy_number_uses(game->defender_spy, snapshot.defender_spy_uses);
+
+  game->attacker_clock.timeouts = snapshot.attacker_timeouts;
+  game->defender_clock.timeouts = snapshot.defender_timeouts;
+  game->attacker_clock.last_direction = snapshot.attacker_last_direction;
+  game->defender_clock.last_direction = snapshot.defender_last_direction;
 }
 
 /*----------------------------------------------------------------------------*/
 
-void play_game(Game game, size_t max_turns) {
+game_undo_t make_game_move(Game game,
+                           direction_t attacker_direction,
+                           direction_t defender_direction) {
+  if (game == NULL) return (game_undo_t) { 0 };
+
+  game_undo_t undo = {
+    .attacker_position = get_item_position(game->attacker),
+    .defender_position = get_item_position(game->defender),
+  };
+
+  move_item_in_field(game->field, game->attacker, attacker_direction);
+  move_item_in_field(game->field, game->defender, defender_direction);
+
+  return undo;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The defender moved last, so it goes back first: only then the cell
+// the attacker left, where the defender may have moved, is empty again
+void unmake_game_move(Game game, game_undo_t undo) {
   if (game == NULL) return;
 
-  printf("Turn 0\n");
-  print_game(game);
+  remove_item_from_field(game->field, game->defender);
+  add_item_to_field(game->field, game->defender, undo.defender_position);
 
-  for (size_t turn = 0; turn < max_turns; turn++) {
-    printf("Turn %ld\n", turn+1);
-
-    move_item(game->field,
-              game->attacker,
-              game->defender_spy,
-              game->execute_attacker_strategy);
-
-    move_item(game->field,
-              game->defender,
-              game->attacker_spy,
-              game->execute_defender_strategy);
-
-    print_game(game);
-
-    if (has_spy_exceeded_max_number_uses(
-          game->defender_spy, game->max_number_spies)) {
-      printf("GAME OVER! Attacker cheated spying more than %ld %s!\n",
-             game->max_number_spies,
-             game->max_number_spies == 1UL ? "time" : "times");
-      return;
-    }
+  remove_item_from_field(game->field, game->attacker);
+  add_item_to_field(game->field, game->attacker, undo.attacker_position);
+}
 
-    if (has_spy_exceeded_max_number_uses(
-          game->attacker_spy, game->max_number_spies)) {
-      printf("GAME OVER! Defender cheated spying more than %ld %s!\n",
-             game->max_number_spies,
-             game->max_number_spies == 1UL ? "time" : "times");
-      return;
-    }
+/*----------------------------------------------------------------------------*/
 
-    if (has_attacker_arrived_end_field(game->field, game->attacker)) {
-      printf("GAME OVER! Attacker wins!\n");
-      return;
-    }
+void reset_game(Game game) {
+  if (game == NULL) return;
+  restore_game(game, game->start);
+}
+
+/*----------------------------------------------------------------------------*/
+
+GamePool new_game_pool(
+    Map map,
+    dimension_t field_dimension,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy) {
+  GamePool pool = malloc(sizeof(*pool));
+
+  pool->arena = new_arena(ARENA_DEFAULT_BLOCK_SIZE);
+
+  pool->map = map;
+  pool->field_dimension = map != NULL
+    ? get_map_dimension(map)
+    : field_dimension;
+  pool->max_number_spies = max_number_spies;
+  pool->attacker_strategy = attacker_strategy;
+  pool->defender_strategy = defender_strategy;
+
+  pool->games = NULL;
+  pool->number_games = 0;
+  pool->released_games = NULL;
+  pool->number_released_games = 0;
+  pool->capacity = 0;
+
+  return pool;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_game_pool(GamePool pool) {
+  if (pool == NULL) return;
+
+  for (size_t k = 0; k < pool->number_games; k++) {
+    delete_game(pool->games[k]);
+  }
+
+  free(pool->released_games);
+  free(pool->games);
+  delete_arena(pool->arena);
+  free(pool);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Released games are cleared as if they were new, except that their
+// strategies keep their contexts until the game is seeded
+Game acquire_pooled_game(GamePool pool) {
+  if (pool == NULL) return NULL;
+
+  if (pool->number_released_games > 0) {
+    Game game = pool->released_games[--pool->number_released_games];
+    game->is_released = false;
+    reset_game(game);
+    clear_game_settings(game);
+    return game;
+  }
+
+  // The capacity only grows when both arrays do, so a failure keeps
+  // the pool as it was
+  if (pool->number_games == pool->capacity) {
+    size_t capacity = pool->capacity == 0 ? 4 : 2 * pool->capacity;
+
+    Game* games = realloc(pool->games, capacity * sizeof(*games));
+    if (games == NULL) return NULL;
+    pool->games = games;
+
+    Game* released_games = realloc(pool->released_games,
+        capacity * sizeof(*released_games));
+    if (released_games == NULL) return NULL;
+    pool->released_games = released_games;
+
+    pool->capacity = capacity;
+  }
+
+  Game game = new_game_in_arena(
+      pool->arena,
+      pool->map,
+      pool->field_dimension,
+      pool->max_number_spies,
+      pool->attacker_strategy,
+      pool->defender_strategy);
+
+  if (game != NULL) pool->games[pool->number_games++] = game;
+
+  return game;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Releasing a game twice would hand it out twice, so it is ignored
+void release_pooled_game(GamePool pool, Game game) {
+  if (pool == NULL || game == NULL || game->arena != pool->arena) return;
+  if (game->is_released) return;
+
+  game->is_released = true;
+  pool->released_games[pool->number_released_games++] = game;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Restarts the strategies with independent seeds derived from the
+// game seed, so the same seed always replays the same game
+void seed_game(Game game, uint64_t seed) {
+  if (game == NULL) return;
+
+  if (game->attacker_strategy.reset_context != NULL) {
+    game->attacker_strategy.reset_context(
+        game->attacker_context, mix_seed(seed, 0));
+  }
+
+  if (game->defender_strategy.reset_context != NULL) {
+    game->defender_strategy.reset_context(
+        game->defender_context, mix_seed(seed, 1));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Histograms are owned by the caller, which may share them between games
+// played by the same thread
+void set_game_latency_histograms(Game game,
+                                 Histogram attacker_latencies,
+                                 Histogram defender_latencies) {
+  if (game == NULL) return;
+
+  game->attacker_clock.latencies = attacker_latencies;
+  game->defender_clock.latencies = defender_latencies;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_game_deadline(Game game, deadline_t deadline) {
+  if (game == NULL) return;
+
+  game->attacker_clock.deadline = deadline;
+  game->defender_clock.deadline = deadline;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The replay is owned by the caller, and receives the turns played next
+void set_game_replay(Game game, Replay replay) {
+  if (game == NULL || replay == NULL) return;
+
+  game_observer_t replay_writer = {
+    .on_turn_end = record_observed_turn,
+    .data = replay,
+  };
+
+  add_game_observer(game, replay_writer);
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool add_game_observer(Game game, game_observer_t observer) {
+  if (game == NULL) return false;
+
+  if (game->number_observers == GAME_MAX_OBSERVERS) {
+    fprintf(stderr, "ERROR: Game cannot have more than %d observers!\n",
+        GAME_MAX_OBSERVERS);
+    return false;
+  }
+
+  game->observers[game->number_observers++] = observer;
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void remove_game_observers(Game game) {
+  if (game == NULL) return;
+
+  game->number_observers = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+Field get_game_field(Game game) {
+  if (game == NULL) return NULL;
+  return game->field;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_game_render_mode(Game game, RenderMode render_mode) {
+  if (game == NULL) return;
+
+  game->render_mode = render_mode;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_game_async_rendering(Game game,
+                              bool is_rendering_async,
+                              bool is_dropping_frames) {
+  if (game == NULL) return;
+
+  game->is_rendering_async = is_rendering_async;
+  game->is_dropping_frames = is_rendering_async && is_dropping_frames;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void print_game(Game game) {
+  if (game == NULL) return;
+
+  if (game->grid_renderer == NULL) {
+    game->grid_renderer = new_renderer(get_field_dimension(game->field),
+                                       RENDER_FULL, STDOUT_FILENO);
+  }
+
+  render_field_grid(game->grid_renderer, game->field);
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_result_t play_game(Game game, size_t max_turns) {
+  if (game == NULL) return (game_result_t) NULL_GAME_RESULT;
+
+  // The printer is the last observer, in the slot kept for it
+  game_printer_t printer = { NULL, NULL };
+  game->observers[game->number_observers++] = make_printer_observer(&printer);
+
+  game_result_t result = run_game(game, max_turns);
+
+  game->number_observers--;
 
-    if (has_defender_captured_attacker(game->attacker, game->defender)) {
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_result_t play_game_quietly(Game game, size_t max_turns) {
+  if (game == NULL) return (game_result_t) NULL_GAME_RESULT;
+
+  return run_game(game, max_turns);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void print_game_result(game_result_t result, size_t max_number_spies) {
+  switch (result.reason) {
+    case REASON_CHEATING:
+      printf("GAME OVER! %s cheated spying more than %ld %s!\n",
+             result.winner == WINNER_DEFENDER ? "Attacker" : "Defender",
+             max_number_spies,
+             max_number_spies == 1UL ? "time" : "times");
+      break;
+    case REASON_GOAL:
+      printf("GAME OVER! Attacker wins!\n");
+      break;
+    case REASON_CAPTURE:
       printf("GAME OVER! Defender wins!\n");
-      return;
+      break;
+    case REASON_DRAW:
+      printf("GAME OVER! Attacker and Defender draw!\n");
+      break;
+  }
+
+  if (result.attacker_timeouts > 0) {
+    printf("Attacker missed the deadline %ld %s\n", result.attacker_timeouts,
+           result.attacker_timeouts == 1UL ? "time" : "times");
+  }
+
+  if (result.defender_timeouts > 0) {
+    printf("Defender missed the deadline %ld %s\n", result.defender_timeouts,
+           result.defender_timeouts == 1UL ? "time" : "times");
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool is_game_over(Game game, game_result_t* result) {
+  if (game == NULL || result == NULL) return false;
+
+  if (has_spy_exceeded_max_number_uses(
+        game->defender_spy, game->max_number_spies)) {
+    *result = make_game_result(game, WINNER_DEFENDER, REASON_CHEATING, 0);
+    return true;
+  }
+
+  if (has_spy_exceeded_max_number_uses(
+        game->attacker_spy, game->max_number_spies)) {
+    *result = make_game_result(game, WINNER_ATTACKER, REASON_CHEATING, 0);
+    return true;
+  }
+
+  if (has_attacker_arrived_end_field(game->field, game->attacker)) {
+    *result = make_game_result(game, WINNER_ATTACKER, REASON_GOAL, 0);
+    return true;
+  }
+
+  if (has_defender_captured_attacker(game->attacker, game->defender)) {
+    *result = make_game_result(game, WINNER_DEFENDER, REASON_CAPTURE, 0);
+    return true;
+  }
+
+  return false;
+}
+
+/*----------------------------------------------------------------------------*/
+
+direction_t execute_clocked_strategy(contextual_strategy_t strategy,
+                                     void* context,
+                                     position_t position,
+                                     Spy opponent_spy,
+                                     strategy_clock_t* clock) {
+  bool has_deadline = clock->deadline.time != 0;
+
+  // The clock is only read when there is a deadline or latencies
+  if (!has_deadline && clock->latencies == NULL) {
+    clock->last_direction = strategy.execute(context, position, opponent_spy);
+    return clock->last_direction;
+  }
+
+  uint64_t start_time = get_monotonic_time();
+  if (has_deadline) strategy_deadline_time = start_time + clock->deadline.time;
+
+  direction_t direction = strategy.execute(context, position, opponent_spy);
+
+  uint64_t elapsed_time = get_monotonic_time() - start_time;
+  strategy_deadline_time = 0;
+
+  record_histogram_value(clock->latencies, elapsed_time);
+
+  if (has_deadline && elapsed_time > clock->deadline.time) {
+    clock->timeouts++;
+    if (clock->deadline.fallback == FALLBACK_STAY) {
+      direction = (direction_t) DIR_STAY;
+    } else {
+      direction = clock->last_direction;
     }
   }
 
-  // A draw happens only if nobody wins before max_turns
-  printf("GAME OVER! Attacker and Defender draw!\n");
+  clock->last_direction = direction;
+
+  return direction;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t get_strategy_remaining_time(void) {
+  if (strategy_deadline_time == 0) return UINT64_MAX;
+
+  uint64_t current_time = get_monotonic_time();
+  if (current_time >= strategy_deadline_time) return 0;
+
+  return strategy_deadline_time - current_time;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -224,51 +917,151 @@ void play_game(Game game, size_t max_turns) {
 /*----------------------------------------------------------------------------*/
 
 Game allocate_game(
-    dimension_t field_dimension,
+    Arena arena,
     size_t max_number_spies,
-    PlayerStrategy execute_attacker_strategy,
-    PlayerStrategy execute_defender_strategy) {
-  Game game = malloc(sizeof(*game));
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy) {
+  Game game = arena != NULL
+    ? allocate_from_arena(arena, sizeof(*game))
+    : malloc(sizeof(*game));
+  if (game == NULL) return NULL;
 
-  game->field = new_field(field_dimension);
+  game->field = NULL;
+  game->arena = arena;
+  game->is_released = false;
+  game->owns_arena = false;
 
   game->max_number_spies = max_number_spies;
 
-  game->execute_attacker_strategy = execute_attacker_strategy;
-  game->execute_defender_strategy = execute_defender_strategy;
+  game->attacker_strategy = attacker_strategy;
+  game->defender_strategy = defender_strategy;
 
-  game->attacker = new_item('A', true);
-  game->defender = new_item('D', true);
-  game->obstacle = new_item('X', false);
+  game->execute_attacker_strategy = NULL;
+  game->execute_defender_strategy = NULL;
+  game->grid_renderer = NULL;
+
+  // Plain strategies have no new_context() and use the function pointers
+  game->attacker_context = attacker_strategy.new_context != NULL
+    ? attacker_strategy.new_context(attacker_strategy.parameters)
+    : &game->execute_attacker_strategy;
+
+  game->defender_context = defender_strategy.new_context != NULL
+    ? defender_strategy.new_context(defender_strategy.parameters)
+    : &game->execute_defender_strategy;
+
+  if (arena != NULL) {
+    game->attacker = new_item_in_arena(arena, 'A', true);
+    game->defender = new_item_in_arena(arena, 'D', true);
+    game->obstacle = new_item_in_arena(arena, 'X', false);
+
+    game->attacker_spy = new_spy_in_arena(arena, game->attacker);
+    game->defender_spy = new_spy_in_arena(arena, game->defender);
+  } else {
+    game->attacker = new_item('A', true);
+    game->defender = new_item('D', true);
+    game->obstacle = new_item('X', false);
+
+    game->attacker_spy = new_spy(game->attacker);
+    game->defender_spy = new_spy(game->defender);
+  }
 
-  game->attacker_spy = new_spy(game->attacker);
-  game->defender_spy = new_spy(game->defender);
+  clear_game_settings(game);
 
   return game;
 }
 
 /*----------------------------------------------------------------------------*/
 
-bool has_map_exceeded_max_occurrences_of_symbol(Map map,
-                                                char symbol,
-                                                size_t max_occurrences) {
-  if (max_occurrences == 0) return false;
-
-  dimension_t map_dimension = get_map_dimension(map);
+// Games without a map are played in a standard field, with borders
+Game new_game_in_arena(
+    Arena arena,
+    Map map,
+    dimension_t field_dimension,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy) {
+  Game game = allocate_game(
+      arena,
+      max_number_spies,
+      attacker_strategy,
+      defender_strategy);
+  if (game == NULL) return NULL;
+
+  game->field = arena != NULL
+    ? new_field_in_arena(arena, field_dimension)
+    : new_field(field_dimension);
+  game->is_standard_field = map == NULL;
+
+  if (map == NULL) {
+    set_attacker_in_field(game->field, game->attacker);
+    set_defender_in_field(game->field, game->defender);
+    set_obstacles_in_field(game->field, game->obstacle);
+
+    game->start = snapshot_game(game);
+    return game;
+  }
 
-  size_t item_symbol_occurrences = 0;
-  for (size_t i = 0; i < map_dimension.height; i++) {
-    for (size_t j = 0; j < map_dimension.width; j++) {
-      position_t current_position = { i, j };
-      char current_map_symbol = get_map_symbol(map, current_position);
+  // Symbols are counted while the map is read, so players are placed
+  // directly and only the obstacles need another pass through the map
+  if (has_map_exceeded_max_occurrences_of_symbol(
+        map, get_item_symbol(game->attacker), MAX_SINGLE_OCCURRENCE)) {
+    fprintf(stderr, "ERROR: Map exceeded max occurrences of symbol %c\n",
+        get_item_symbol(game->attacker));
+    delete_game(game);
+    return NULL;
+  }
 
-      if (current_map_symbol == symbol) {
-        item_symbol_occurrences++;
-      }
-    }
+  if (has_map_exceeded_max_occurrences_of_symbol(
+        map, get_item_symbol(game->defender), MAX_SINGLE_OCCURRENCE)) {
+    fprintf(stderr, "ERROR: Map exceeded max occurrences of symbol %c\n",
+        get_item_symbol(game->defender));
+    delete_game(game);
+    return NULL;
   }
 
-  return item_symbol_occurrences > max_occurrences ? true : false;
+  set_single_item_in_field_from_map(game->field, game->attacker, map);
+  set_single_item_in_field_from_map(game->field, game->defender, map);
+  set_item_in_field_from_map(game->field, game->obstacle, map);
+
+  game->start = snapshot_game(game);
+  return game;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Settings are given to each game after it is created, and pooled games
+// lose them when they are released
+void clear_game_settings(Game game) {
+  game->attacker_clock = (strategy_clock_t) NULL_STRATEGY_CLOCK;
+  game->defender_clock = (strategy_clock_t) NULL_STRATEGY_CLOCK;
+
+  game->number_observers = 0;
+  game->render_mode = RENDER_FULL;
+  game->is_rendering_async = false;
+  game->is_dropping_frames = false;
+}
+
+/*----------------------------------------------------------------------------*/
+
+contextual_strategy_t make_plain_strategy_contextual() {
+  contextual_strategy_t strategy = {
+    .new_context = NULL,
+    .reset_context = NULL,
+    .delete_context = NULL,
+    .execute = execute_plain_strategy,
+    .parameters = NULL,
+  };
+
+  return strategy;
+}
+
+/*----------------------------------------------------------------------------*/
+
+direction_t execute_plain_strategy(void* context,
+                                   position_t position,
+                                   Spy opponent_spy) {
+  PlayerStrategy* execute_strategy = context;
+  return (*execute_strategy)(position, opponent_spy);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -299,6 +1092,16 @@ void set_item_in_field_from_map(Field field,
 
 /*----------------------------------------------------------------------------*/
 
+// Places an item that appears at most once in the map, if it appears
+void set_single_item_in_field_from_map(Field field, Item item, Map map) {
+  char item_symbol = get_item_symbol(item);
+  if (get_map_symbol_occurrences(map, item_symbol) == 0) return;
+
+  add_item_to_field(field, item, get_map_symbol_position(map, item_symbol));
+}
+
+/*----------------------------------------------------------------------------*/
+
 void set_attacker_in_field(Field field, Item attacker) {
   if (field == NULL || attacker == NULL) return;
 
@@ -326,29 +1129,7 @@ void set_defender_in_field(Field field, Item defender) {
 /*----------------------------------------------------------------------------*/
 
 void set_obstacles_in_field(Field field, Item obstacle) {
-  dimension_t field_dimension = get_field_dimension(field);
-  size_t field_height = field_dimension.height;
-  size_t field_width = field_dimension.width;
-
-  for (size_t i = 0; i < field_height; i++) {
-    position_t left_border = { i, 0 };
-    add_item_to_field(field, obstacle, left_border);
-  }
-
-  for (size_t i = 0; i < field_height; i++) {
-    position_t right_border = { i, field_width-1 };
-    add_item_to_field(field, obstacle, right_border);
-  }
-
-  for (size_t j = 0; j < field_width; j++) {
-    position_t top_border = { 0, j };
-    add_item_to_field(field, obstacle, top_border);
-  }
-
-  for (size_t j = 0; j < field_width; j++) {
-    position_t bottom_border = { field_height-1, j };
-    add_item_to_field(field, obstacle, bottom_border);
-  }
+  add_border_to_field(field, obstacle);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -382,16 +1163,282 @@ bool has_attacker_arrived_end_field(Field field, Item attacker) {
 
 /*----------------------------------------------------------------------------*/
 
-void move_item(Field field,
-               Item item,
-               Spy opponent_spy,
-               PlayerStrategy execute_item_strategy) {
+replay_move_t move_item(Field field,
+                        Item item,
+                        Spy opponent_spy,
+                        contextual_strategy_t item_strategy,
+                        void* item_context,
+                        strategy_clock_t* item_clock) {
   position_t item_position = get_item_position(item);
+  size_t spy_uses = get_spy_number_uses(opponent_spy);
 
-  direction_t item_direction
-    = execute_item_strategy(item_position, opponent_spy);
+  direction_t item_direction = execute_clocked_strategy(
+      item_strategy, item_context, item_position, opponent_spy, item_clock);
 
   move_item_in_field(field, item, item_direction);
+
+  replay_move_t item_move = {
+    .direction = item_direction,
+    .spy_uses = get_spy_number_uses(opponent_spy) - spy_uses,
+  };
+
+  return item_move;
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_result_t run_game(Game game, size_t max_turns) {
+#ifndef NO_SPECIALIZED_GAMES
+  const specialized_game_t* specialized_game = find_specialized_game(game);
+  if (specialized_game != NULL) return specialized_game->run(game, max_turns);
+#endif
+
+  notify_game_start(game);
+
+  game_result_t result;
+  for (size_t turn = 0; turn < max_turns; turn++) {
+    replay_move_t attacker_move = move_item(game->field,
+                                            game->attacker,
+                                            game->defender_spy,
+                                            game->attacker_strategy,
+                                            game->attacker_context,
+                                            &game->attacker_clock);
+
+    replay_move_t defender_move = move_item(game->field,
+                                            game->defender,
+                                            game->attacker_spy,
+                                            game->defender_strategy,
+                                            game->defender_context,
+                                            &game->defender_clock);
+
+    notify_turn_end(game, turn+1, attacker_move, defender_move);
+
+    if (is_game_over(game, &result)) {
+      result.turns = turn+1;
+      notify_game_end(game, result);
+      return result;
+    }
+  }
+
+  // A draw happens only if nobody wins before max_turns
+  result = make_game_result(game, WINNER_NONE, REASON_DRAW, max_turns);
+  notify_game_end(game, result);
+
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Games with observers or clocks need every turn to go through them
+const specialized_game_t* find_specialized_game(Game game) {
+  bool has_clocks = game->attacker_clock.deadline.time != 0
+    || game->defender_clock.deadline.time != 0
+    || game->attacker_clock.latencies != NULL
+    || game->defender_clock.latencies != NULL;
+
+  if (!game->is_standard_field || game->number_observers > 0 || has_clocks) {
+    return NULL;
+  }
+
+  dimension_t field_dimension = get_field_dimension(game->field);
+
+  size_t number_specialized_games
+    = sizeof(specialized_games) / sizeof(*specialized_games);
+  for (size_t k = 0; k < number_specialized_games; k++) {
+    const specialized_game_t* specialized_game = &specialized_games[k];
+
+    if (game->attacker_strategy.execute
+          == specialized_game->execute_attacker_strategy
+        && game->defender_strategy.execute
+          == specialized_game->execute_defender_strategy
+        && field_dimension.height == specialized_game->field_dimension.height
+        && field_dimension.width == specialized_game->field_dimension.width) {
+      return specialized_game;
+    }
+  }
+
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+DEFINE_SPECIALIZED_GAME(run_standard_game,
+                        execute_attacker_strategy_in_context,
+                        execute_defender_strategy_in_context,
+                        STANDARD_FIELD_HEIGHT,
+                        STANDARD_FIELD_WIDTH)
+
+/*----------------------------------------------------------------------------*/
+
+// Players leave the field before any of them comes back, as in
+// restore_game(), since the field still has them where they started
+void update_players_in_field(Game game) {
+  position_t attacker_position = get_item_position(game->attacker);
+  position_t defender_position = get_item_position(game->defender);
+
+  remove_item_from_field(game->field, game->attacker);
+  remove_item_from_field(game->field, game->defender);
+  add_item_to_field(game->field, game->attacker, attacker_position);
+  add_item_to_field(game->field, game->defender, defender_position);
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_result_t make_game_result(Game game,
+                               Winner winner,
+                               GameOverReason reason,
+                               size_t turns) {
+  game_result_t result = {
+    .winner = winner,
+    .reason = reason,
+    .turns = turns,
+    // The defender spy is used by the attacker and vice-versa
+    .attacker_spy_uses = get_spy_number_uses(game->defender_spy),
+    .defender_spy_uses = get_spy_number_uses(game->attacker_spy),
+    .attacker_timeouts = game->attacker_clock.timeouts,
+    .defender_timeouts = game->defender_clock.timeouts,
+  };
+
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void notify_game_start(Game game) {
+  for (size_t k = 0; k < game->number_observers; k++) {
+    game_observer_t* observer = &game->observers[k];
+    if (observer->on_game_start == NULL) continue;
+
+    observer->on_game_start(observer->data, game);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Spy uses are notified before the end of the turn where they happened
+void notify_turn_end(Game game,
+                     size_t turn,
+                     replay_move_t attacker_move,
+                     replay_move_t defender_move) {
+  for (size_t k = 0; k < game->number_observers; k++) {
+    game_observer_t* observer = &game->observers[k];
+
+    if (observer->on_spy_use != NULL) {
+      if (attacker_move.spy_uses > 0) {
+        observer->on_spy_use(observer->data, game, turn,
+                             REPLAY_ATTACKER, attacker_move.spy_uses);
+      }
+
+      if (defender_move.spy_uses > 0) {
+        observer->on_spy_use(observer->data, game, turn,
+                             REPLAY_DEFENDER, defender_move.spy_uses);
+      }
+    }
+
+    if (observer->on_turn_end != NULL) {
+      observer->on_turn_end(observer->data, game, turn,
+                            attacker_move, defender_move);
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void notify_game_end(Game game, game_result_t result) {
+  for (size_t k = 0; k < game->number_observers; k++) {
+    game_observer_t* observer = &game->observers[k];
+    if (observer->on_game_end == NULL) continue;
+
+    observer->on_game_end(observer->data, game, result);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void record_observed_turn(void* replay,
+                          Game game,
+                          size_t turn,
+                          replay_move_t attacker_move,
+                          replay_move_t defender_move) {
+  UNUSED(game);
+  UNUSED(turn);
+
+  record_replay_turn(replay, attacker_move, defender_move);
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_observer_t make_printer_observer(game_printer_t* printer) {
+  game_observer_t observer = {
+    .on_game_start = start_printing_game,
+    .on_spy_use = NULL,
+    .on_turn_end = print_turn,
+    .on_game_end = print_game_end,
+    .data = printer,
+  };
+
+  return observer;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void start_printing_game(void* printer, Game game) {
+  game_printer_t* self = printer;
+
+  if (game->is_rendering_async) {
+    Item movable_items[] = { game->attacker, game->defender };
+    self->async_renderer = new_async_renderer(
+        game->field, movable_items, 2,
+        game->render_mode, STDOUT_FILENO, game->is_dropping_frames);
+  }
+
+  // Games are drawn by the current thread if the render thread could
+  // not be started
+  if (self->async_renderer == NULL) {
+    self->renderer = new_renderer(get_field_dimension(game->field),
+                                  game->render_mode, STDOUT_FILENO);
+  }
+
+  render_turn(self, game->field, 0);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void print_turn(void* printer,
+                Game game,
+                size_t turn,
+                replay_move_t attacker_move,
+                replay_move_t defender_move) {
+  UNUSED(attacker_move);
+  UNUSED(defender_move);
+
+  render_turn(printer, game->field, turn);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The render thread is stopped before the result is printed,
+// so the result always comes after the last frame
+void print_game_end(void* printer, Game game, game_result_t result) {
+  game_printer_t* self = printer;
+
+  delete_renderer(self->renderer);
+  delete_async_renderer(self->async_renderer);
+  self->renderer = NULL;
+  self->async_renderer = NULL;
+
+  print_game_result(result, game->max_number_spies);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void render_turn(game_printer_t* printer, Field field, size_t turn) {
+  if (printer->async_renderer != NULL) {
+    push_async_frame(printer->async_renderer, turn);
+    return;
+  }
+
+  render_field(printer->renderer, field, turn);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -0,0 +1,153 @@
+// Standard headers
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Main header
+#include "histogram.h"
+
+// Macros
+#define SUB_BUCKET_BITS 5
+#define SUB_BUCKETS (1ULL << SUB_BUCKET_BITS)
+
+// Values below SUB_BUCKETS are exact, and every power of two above it
+// is split in SUB_BUCKETS buckets of the same width
+#define NUMBER_BUCKETS (SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS)
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+struct histogram {
+  uint64_t count;
+  uint64_t max;
+  uint64_t buckets[NUMBER_BUCKETS];
+};
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+size_t get_bucket_index(uint64_t value);
+uint64_t get_bucket_highest_value(size_t index);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+Histogram new_histogram(void) {
+  Histogram histogram = malloc(sizeof(*histogram));
+
+  reset_histogram(histogram);
+
+  return histogram;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_histogram(Histogram histogram) {
+  if (histogram == NULL) return;
+
+  histogram->count = 0;
+
+  free(histogram);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void reset_histogram(Histogram histogram) {
+  if (histogram == NULL) return;
+
+  histogram->count = 0;
+  histogram->max = 0;
+  memset(histogram->buckets, 0, sizeof(histogram->buckets));
+}
+
+/*----------------------------------------------------------------------------*/
+
+void record_histogram_value(Histogram histogram, uint64_t value) {
+  if (histogram == NULL) return;
+
+  histogram->buckets[get_bucket_index(value)]++;
+  histogram->count++;
+  if (value > histogram->max) histogram->max = value;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void merge_histograms(Histogram histogram, Histogram other) {
+  if (histogram == NULL || other == NULL) return;
+
+  for (size_t index = 0; index < NUMBER_BUCKETS; index++) {
+    histogram->buckets[index] += other->buckets[index];
+  }
+
+  histogram->count += other->count;
+  if (other->max > histogram->max) histogram->max = other->max;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t get_histogram_count(Histogram histogram) {
+  if (histogram == NULL) return 0;
+  return histogram->count;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t get_histogram_max(Histogram histogram) {
+  if (histogram == NULL) return 0;
+  return histogram->max;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Smallest bucket value that is greater than or equal to the given
+// percentage (between 0 and 100) of the recorded values
+uint64_t get_histogram_percentile(Histogram histogram, double percentile) {
+  if (histogram == NULL || histogram->count == 0) return 0;
+
+  uint64_t rank = (uint64_t) (percentile / 100.0 * histogram->count + 0.5);
+  if (rank == 0) rank = 1;
+  if (rank > histogram->count) rank = histogram->count;
+
+  uint64_t cumulative_count = 0;
+  for (size_t index = 0; index < NUMBER_BUCKETS; index++) {
+    cumulative_count += histogram->buckets[index];
+
+    if (cumulative_count >= rank) {
+      uint64_t value = get_bucket_highest_value(index);
+      return value < histogram->max ? value : histogram->max;
+    }
+  }
+
+  return histogram->max;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+size_t get_bucket_index(uint64_t value) {
+  if (value < SUB_BUCKETS) return value;
+
+  size_t exponent = 63 - __builtin_clzll(value);
+  size_t shift = exponent - SUB_BUCKET_BITS;
+  size_t sub_bucket = (value >> shift) - SUB_BUCKETS;
+
+  return SUB_BUCKETS + shift * SUB_BUCKETS + sub_bucket;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t get_bucket_highest_value(size_t index) {
+  if (index < SUB_BUCKETS) return index;
+
+  size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+  size_t sub_bucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+
+  uint64_t lowest_value = (SUB_BUCKETS + sub_bucket) << shift;
+  return lowest_value + ((1ULL << shift) - 1);
+}
+
+/*----------------------------------------------------------------------------*/
@@ -2,6 +2,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+// Internal headers
+#include "arena.h"
+
 // Main header
 #include "item.h"
 
@@ -13,18 +16,33 @@ struct item {
   char symbol;
   bool is_movable;
   position_t position;
+  size_t field_code;
 };
 
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+void init_item(Item item, char symbol, bool is_movable);
+
 /*----------------------------------------------------------------------------*/
 /*                              PUBLIC FUNCTIONS                              */
 /*----------------------------------------------------------------------------*/
 
 Item new_item(char symbol, bool is_movable) {
   Item item = malloc(sizeof(*item));
+  init_item(item, symbol, is_movable);
 
-  item->symbol = symbol;
-  item->is_movable = is_movable;
-  item->position = (position_t) INVALID_POSITION;
+  return item;
+}
+
+/*----------------------------------------------------------------------------*/
+
+Item new_item_in_arena(Arena arena, char symbol, bool is_movable) {
+  Item item = allocate_from_arena(arena, sizeof(*item));
+  if (item == NULL) return NULL;
+
+  init_item(item, symbol, is_movable);
 
   return item;
 }
@@ -68,9 +86,34 @@ void set_item_position(Item item, position_t new_position) {
 
 /*----------------------------------------------------------------------------*/
 
+size_t get_item_field_code(Item item) {
+  if (item == NULL) return 0;
+  return item->field_code;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_item_field_code(Item item, size_t field_code) {
+  if (item == NULL) return;
+  item->field_code = field_code;
+}
+
+/*----------------------------------------------------------------------------*/
+
 bool equal_items(Item p1, Item p2) {
   if (p1 == NULL || p2 == NULL) return false;
   return p1 == p2;
 }
 
 /*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+void init_item(Item item, char symbol, bool is_movable) {
+  item->symbol = symbol;
+  item->is_movable = is_movable;
+  item->position = (position_t) INVALID_POSITION;
+  item->field_code = 0;
+}
+
+/*----------------------------------------------------------------------------*/
@@ -1,87 +1,717 @@
 // Standard headers
 #include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 // Internal headers
 #include "attacker.h"
 #include "defender.h"
 #include "dimension.h"
+#include "distance_field.h"
+#include "field.h"
 #include "map.h"
 #include "game.h"
+#include "histogram.h"
+#include "mcts_attacker.h"
+#include "random.h"
+#include "renderer.h"
+#include "replay.h"
+#include "tablebase.h"
+#include "team_game.h"
+#include "timer.h"
+#include "tournament.h"
 
 // Macros
 #define STANDARD_FIELD_DIMENSION (dimension_t) { 10, 10 }
 #define STANDARD_MAX_NUMBER_SPIES 1LU
 #define STANDARD_MAX_TURNS 42
+#define NANOSECONDS_PER_SECOND 1e9
+
+/*----------------------------------------------------------------------------*/
+/*                             AUXILIARY STRUCTS                              */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Options given by the command line.
+ */
+struct options {
+  const char* map_path;
+  const char* record_path;
+  const char* replay_path;
+  const char* oracle_path;
+  dimension_t field_dimension;
+  size_t number_attackers;
+  size_t number_defenders;
+  size_t max_turns;
+  size_t number_games;
+  size_t number_threads;
+  size_t batch_size;
+  uint64_t seed;
+  bool is_quiet;
+  bool is_measuring_latency;
+  deadline_t deadline;
+  RenderMode render_mode;
+  bool is_rendering_async;
+  bool is_dropping_frames;
+  contextual_strategy_t attacker_strategy;
+  mcts_parameters_t mcts_parameters;
+  Tablebase oracle;
+};
+typedef struct options options_t;
+
+/**
+ * How long the strategy calls took, in nanoseconds. Both histograms
+ * are NULL if latencies are not measured.
+ */
+struct latencies {
+  Histogram attacker;
+  Histogram defender;
+};
+typedef struct latencies latencies_t;
 
 /*----------------------------------------------------------------------------*/
 /*                       AUXILIARY FUNCTIONS DECLARATION                      */
 /*----------------------------------------------------------------------------*/
 
-Game choose_game(int argc, char** argv);
-Game make_standard_game();
-Game make_game_from_map(const char* map_path);
+bool parse_options(int argc, char** argv, options_t* options);
+
+Game choose_game(Map map,
+                 dimension_t field_dimension,
+                 contextual_strategy_t attacker_strategy);
+Game make_standard_game(dimension_t field_dimension,
+                        contextual_strategy_t attacker_strategy);
+Game make_game_from_map(Map map, contextual_strategy_t attacker_strategy);
+
+int play_single_game(options_t options, Map map, latencies_t latencies);
+int play_many_games(options_t options, Map map, latencies_t latencies);
+int play_many_games_quietly(options_t options,
+                            Map map,
+                            latencies_t latencies);
+int play_replay(options_t options, Map map);
+int play_team_games(options_t options, Map map);
+
+bool add_oracle_observer(Game game, tablebase_oracle_t* oracle);
+
+void print_statistics(statistics_t statistics);
+void print_tablebase_score(tablebase_score_t score);
+void print_thread_statistics(statistics_t* thread_statistics,
+                             size_t number_threads);
+void print_latencies(latencies_t latencies);
+void print_latency(const char* player, Histogram latencies);
 
 /*----------------------------------------------------------------------------*/
 /*                               MAIN FUNCTION                                */
 /*----------------------------------------------------------------------------*/
 
 int main(int argc, char** argv) {
-  if (argc >= 3) {
-    fprintf(stderr, "USAGE: %s [map_path]\n", argv[0]);
+  options_t options;
+  if (!parse_options(argc, argv, &options)) {
+    fprintf(stderr, "USAGE: %s [--games N] [--threads T] [--batch K] "
+        "[--seed S] [--quiet] [--latency] [--deadline NS] "
+        "[--fallback stay|last] [--record FILE | --replay FILE] "
+        "[--render full|diff] [--async-render [--drop-frames]] "
+        "[--attacker classic|mcts] [--rollouts N] [--search-threads T] "
+        "[--oracle TABLEBASE] [--field HxW] [--teams KxM] [--turns N] "
+        "[map_path]\n", argv[0]);
     return EXIT_FAILURE;
   }
 
-  printf("## RUGBY GAME ##\n\n");
+  Map map = NULL;
+  if (options.map_path != NULL) {
+    map = new_map(options.map_path);
+    if (map == NULL) return EXIT_FAILURE;
+  }
+
+  // The MCTS attacker points to these parameters, so it sees the map
+  // and the distance field shared by all games
+  options.mcts_parameters.map = map;
+  if (options.attacker_strategy.new_context == new_mcts_attacker_context) {
+    options.mcts_parameters.distance_field = map != NULL
+      ? new_distance_field(map)
+      : new_bordered_distance_field(options.field_dimension);
 
-  Game game = choose_game(argc, argv);
-  play_game(game, STANDARD_MAX_TURNS);
-  delete_game(game);
+    if (options.mcts_parameters.distance_field == NULL) {
+      fprintf(stderr, "ERROR: Could not allocate the distance field\n");
+      delete_map(map);
+      return EXIT_FAILURE;
+    }
+  }
 
-  return EXIT_SUCCESS;
+  // Moves are scored against the tablebase of the map where they are played
+  if (options.oracle_path != NULL) {
+    options.oracle = load_tablebase(options.oracle_path);
+
+    dimension_t dimension = get_tablebase_dimension(options.oracle);
+    bool is_same_map = map != NULL
+      ? get_tablebase_map_hash(options.oracle) == get_map_hash(map)
+      : is_tablebase_of_bordered_field(options.oracle)
+        && dimension.height == options.field_dimension.height
+        && dimension.width == options.field_dimension.width;
+
+    if (options.oracle == NULL || !is_same_map) {
+      if (options.oracle != NULL) {
+        fprintf(stderr, "ERROR: Tablebase was not generated for this map\n");
+      }
+      delete_tablebase(options.oracle);
+      delete_distance_field(options.mcts_parameters.distance_field);
+      delete_map(map);
+      return EXIT_FAILURE;
+    }
+  }
+
+  latencies_t latencies = { NULL, NULL };
+  if (options.is_measuring_latency) {
+    latencies.attacker = new_histogram();
+    latencies.defender = new_histogram();
+  }
+
+  if (!options.is_quiet) printf("## RUGBY GAME ##\n\n");
+
+  int status;
+  if (options.replay_path != NULL) {
+    status = play_replay(options, map);
+  } else if (options.number_attackers > 0) {
+    status = play_team_games(options, map);
+  } else if (options.is_quiet) {
+    status = play_many_games_quietly(options, map, latencies);
+  } else if (options.number_games == 1) {
+    status = play_single_game(options, map, latencies);
+  } else {
+    status = play_many_games(options, map, latencies);
+  }
+
+  if (status == EXIT_SUCCESS && options.is_measuring_latency) {
+    print_latencies(latencies);
+  }
+
+  delete_histogram(latencies.defender);
+  delete_histogram(latencies.attacker);
+  delete_tablebase(options.oracle);
+  delete_distance_field(options.mcts_parameters.distance_field);
+  delete_map(map);
+
+  return status;
 }
 
 /*----------------------------------------------------------------------------*/
 /*                             AUXILIARY FUNCTIONS                            */
 /*----------------------------------------------------------------------------*/
 
-Game choose_game(int argc, char** argv) {
-  switch (argc) {
-    case 1: return make_standard_game();
-    case 2: return make_game_from_map(argv[1]);
-    default:
-      // argc should not be any other number
-      assert(false);
+bool parse_options(int argc, char** argv, options_t* options) {
+  options->map_path = NULL;
+  options->record_path = NULL;
+  options->replay_path = NULL;
+  options->oracle_path = NULL;
+  options->field_dimension = STANDARD_FIELD_DIMENSION;
+  options->number_attackers = 0;
+  options->number_defenders = 0;
+  options->max_turns = STANDARD_MAX_TURNS;
+  options->number_games = 1;
+  options->number_threads = 1;
+  options->batch_size = 0;
+  options->seed = time(NULL);
+  options->is_quiet = false;
+  options->is_measuring_latency = false;
+  options->deadline = (deadline_t) NO_DEADLINE;
+  options->render_mode = RENDER_FULL;
+  options->is_rendering_async = false;
+  options->is_dropping_frames = false;
+  options->attacker_strategy
+    = (contextual_strategy_t) ATTACKER_CONTEXTUAL_STRATEGY;
+  options->mcts_parameters = (mcts_parameters_t) DEFAULT_MCTS_PARAMETERS;
+  options->oracle = NULL;
+
+  for (int k = 1; k < argc; k++) {
+    if (strcmp(argv[k], "--quiet") == 0) {
+      options->is_quiet = true;
+    } else if (strcmp(argv[k], "--latency") == 0) {
+      options->is_measuring_latency = true;
+    } else if (strcmp(argv[k], "--async-render") == 0) {
+      options->is_rendering_async = true;
+    } else if (strcmp(argv[k], "--drop-frames") == 0) {
+      options->is_dropping_frames = true;
+    } else if (strcmp(argv[k], "--games") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->number_games = strtoul(argv[++k], &end, 10);
+      if (*end != '\0' || options->number_games == 0) return false;
+    } else if (strcmp(argv[k], "--threads") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->number_threads = strtoul(argv[++k], &end, 10);
+      if (*end != '\0' || options->number_threads == 0) return false;
+    } else if (strcmp(argv[k], "--batch") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->batch_size = strtoul(argv[++k], &end, 10);
+      if (*end != '\0') return false;
+    } else if (strcmp(argv[k], "--deadline") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->deadline.time = strtoull(argv[++k], &end, 10);
+      if (*end != '\0') return false;
+    } else if (strcmp(argv[k], "--fallback") == 0) {
+      if (k+1 == argc) return false;
+
+      k++;
+      if (strcmp(argv[k], "stay") == 0) {
+        options->deadline.fallback = FALLBACK_STAY;
+      } else if (strcmp(argv[k], "last") == 0) {
+        options->deadline.fallback = FALLBACK_LAST_DIRECTION;
+      } else {
+        return false;
+      }
+    } else if (strcmp(argv[k], "--render") == 0) {
+      if (k+1 == argc) return false;
+
+      k++;
+      if (strcmp(argv[k], "full") == 0) {
+        options->render_mode = RENDER_FULL;
+      } else if (strcmp(argv[k], "diff") == 0) {
+        options->render_mode = RENDER_DIFF;
+      } else {
+        return false;
+      }
+    } else if (strcmp(argv[k], "--attacker") == 0) {
+      if (k+1 == argc) return false;
+
+      k++;
+      if (strcmp(argv[k], "classic") == 0) {
+        options->attacker_strategy
+          = (contextual_strategy_t) ATTACKER_CONTEXTUAL_STRATEGY;
+      } else if (strcmp(argv[k], "mcts") == 0) {
+        options->attacker_strategy = (contextual_strategy_t)
+          MCTS_ATTACKER_CONTEXTUAL_STRATEGY(&options->mcts_parameters);
+      } else {
+        return false;
+      }
+    } else if (strcmp(argv[k], "--rollouts") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->mcts_parameters.number_rollouts = strtoul(argv[++k], &end, 10);
+      if (*end != '\0' || options->mcts_parameters.number_rollouts == 0) {
+        return false;
+      }
+    } else if (strcmp(argv[k], "--search-threads") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->mcts_parameters.number_threads = strtoul(argv[++k], &end, 10);
+      if (*end != '\0' || options->mcts_parameters.number_threads == 0
+          || options->mcts_parameters.number_threads > MCTS_MAX_THREADS) {
+        return false;
+      }
+    } else if (strcmp(argv[k], "--record") == 0) {
+      if (k+1 == argc) return false;
+      options->record_path = argv[++k];
+    } else if (strcmp(argv[k], "--replay") == 0) {
+      if (k+1 == argc) return false;
+      options->replay_path = argv[++k];
+    } else if (strcmp(argv[k], "--field") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->field_dimension.height = strtoul(argv[++k], &end, 10);
+      if (*end != 'x') return false;
+      options->field_dimension.width = strtoul(end+1, &end, 10);
+      if (*end != '\0') return false;
+
+      dimension_t min_dimension = FIELD_MIN_DIMENSION;
+      if (options->field_dimension.height < min_dimension.height
+          || options->field_dimension.width < min_dimension.width) {
+        return false;
+      }
+    } else if (strcmp(argv[k], "--teams") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->number_attackers = strtoul(argv[++k], &end, 10);
+      if (*end != 'x') return false;
+      options->number_defenders = strtoul(end+1, &end, 10);
+      if (*end != '\0') return false;
+
+      if (options->number_attackers == 0 || options->number_defenders == 0) {
+        return false;
+      }
+    } else if (strcmp(argv[k], "--turns") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->max_turns = strtoul(argv[++k], &end, 10);
+      if (*end != '\0' || options->max_turns == 0) return false;
+    } else if (strcmp(argv[k], "--oracle") == 0) {
+      if (k+1 == argc) return false;
+      options->oracle_path = argv[++k];
+    } else if (strcmp(argv[k], "--seed") == 0) {
+      if (k+1 == argc) return false;
+
+      char* end = NULL;
+      options->seed = strtoull(argv[++k], &end, 10);
+      if (*end != '\0') return false;
+    } else if (argv[k][0] == '-' || options->map_path != NULL) {
+      return false;
+    } else {
+      options->map_path = argv[k];
+    }
+  }
+
+  options->mcts_parameters.field_dimension = options->field_dimension;
+
+  // Batches have no observers to score their moves
+  if (options->oracle_path != NULL && options->batch_size > 0) return false;
+
+  // Team games are played one at a time, with no observers or clocks
+  bool is_team_game = options->number_attackers > 0;
+  if (is_team_game
+      && (options->record_path != NULL || options->replay_path != NULL
+        || options->oracle_path != NULL || options->batch_size > 0
+        || options->number_threads > 1 || options->is_measuring_latency
+        || options->deadline.time != 0 || options->is_rendering_async)) {
+    return false;
+  }
+
+  // Replays are recorded and played one game at a time
+  bool is_single_game = options->number_games == 1 && !options->is_quiet;
+  if (options->record_path != NULL && options->replay_path != NULL) {
+    return false;
+  }
+  if (options->record_path != NULL
+      && options->max_turns > REPLAY_MAX_TURNS) {
+    return false;
+  }
+  if (options->record_path != NULL || options->replay_path != NULL) {
+    return is_single_game;
+  }
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+Game choose_game(Map map,
+                 dimension_t field_dimension,
+                 contextual_strategy_t attacker_strategy) {
+  if (map == NULL) {
+    return make_standard_game(field_dimension, attacker_strategy);
   }
+  return make_game_from_map(map, attacker_strategy);
 }
 
 /*----------------------------------------------------------------------------*/
 
-Game make_standard_game() {
-  Game game = new_game(
-      STANDARD_FIELD_DIMENSION,
+Game make_standard_game(dimension_t field_dimension,
+                        contextual_strategy_t attacker_strategy) {
+  Game game = new_contextual_game(
+      field_dimension,
       STANDARD_MAX_NUMBER_SPIES,
-      execute_attacker_strategy,
-      execute_defender_strategy);
+      attacker_strategy,
+      (contextual_strategy_t) DEFENDER_CONTEXTUAL_STRATEGY);
 
   return game;
 }
 
 /*----------------------------------------------------------------------------*/
 
-Game make_game_from_map(const char* map_path) {
-  Map map = new_map(map_path);
-
-  Game game = new_game_from_map(
+Game make_game_from_map(Map map, contextual_strategy_t attacker_strategy) {
+  Game game = new_contextual_game_from_map(
       map,
       STANDARD_MAX_NUMBER_SPIES,
-      execute_attacker_strategy,
-      execute_defender_strategy);
-
-  delete_map(map);
+      attacker_strategy,
+      (contextual_strategy_t) DEFENDER_CONTEXTUAL_STRATEGY);
 
   return game;
 }
 
 /*----------------------------------------------------------------------------*/
+
+int play_single_game(options_t options, Map map, latencies_t latencies) {
+  assert(options.number_games == 1);
+
+  Game game = choose_game(map, options.field_dimension,
+                          options.attacker_strategy);
+  if (game == NULL) return EXIT_FAILURE;
+
+  seed_game(game, mix_seed(options.seed, 0));
+  set_game_deadline(game, options.deadline);
+  set_game_render_mode(game, options.render_mode);
+  set_game_async_rendering(game, options.is_rendering_async,
+                           options.is_dropping_frames);
+  set_game_latency_histograms(game, latencies.attacker, latencies.defender);
+
+  tablebase_oracle_t oracle = { .tablebase = options.oracle };
+  add_oracle_observer(game, &oracle);
+
+  Replay replay = NULL;
+  if (options.record_path != NULL) {
+    replay = new_replay();
+    set_replay_map_hash(replay, get_map_hash(map));
+    set_game_replay(game, replay);
+  }
+
+  play_game(game, options.max_turns);
+  delete_game(game);
+
+  if (oracle.tablebase != NULL) print_tablebase_score(oracle.score);
+
+  bool is_saved = replay == NULL || save_replay(replay, options.record_path);
+  delete_replay(replay);
+
+  return is_saved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*----------------------------------------------------------------------------*/
+
+int play_many_games(options_t options, Map map, latencies_t latencies) {
+  statistics_t statistics = NULL_STATISTICS;
+  tablebase_oracle_t oracle = { .tablebase = options.oracle };
+
+  uint64_t start_time = get_monotonic_time();
+
+  for (size_t k = 0; k < options.number_games; k++) {
+    Game game = choose_game(map, options.field_dimension,
+                            options.attacker_strategy);
+    if (game == NULL) return EXIT_FAILURE;
+
+    seed_game(game, mix_seed(options.seed, k));
+    set_game_deadline(game, options.deadline);
+    set_game_render_mode(game, options.render_mode);
+    set_game_async_rendering(game, options.is_rendering_async,
+                             options.is_dropping_frames);
+    set_game_latency_histograms(game, latencies.attacker, latencies.defender);
+    add_game_observer(game, make_statistics_observer(&statistics));
+    add_oracle_observer(game, &oracle);
+    play_game(game, options.max_turns);
+
+    delete_game(game);
+  }
+
+  statistics.elapsed_time = get_monotonic_time() - start_time;
+  statistics.score = oracle.score;
+  print_statistics(statistics);
+
+  return EXIT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+
+int play_many_games_quietly(options_t options,
+                            Map map,
+                            latencies_t latencies) {
+  tournament_t tournament = {
+    .map = map,
+    .field_dimension = options.field_dimension,
+    .max_number_spies = STANDARD_MAX_NUMBER_SPIES,
+    .max_turns = options.max_turns,
+    .attacker_strategy = options.attacker_strategy,
+    .defender_strategy = DEFENDER_CONTEXTUAL_STRATEGY,
+    .number_games = options.number_games,
+    .number_threads = options.number_threads,
+    .batch_size = options.batch_size,
+    .seed = options.seed,
+    .deadline = options.deadline,
+    .attacker_latencies = latencies.attacker,
+    .defender_latencies = latencies.defender,
+    .tablebase = options.oracle,
+  };
+
+  statistics_t* thread_statistics
+    = malloc(options.number_threads * sizeof(*thread_statistics));
+
+  statistics_t statistics = play_tournament(tournament, thread_statistics);
+
+  if (statistics.games == 0) {
+    free(thread_statistics);
+    return EXIT_FAILURE;
+  }
+
+  print_statistics(statistics);
+  print_thread_statistics(thread_statistics, options.number_threads);
+
+  free(thread_statistics);
+
+  return EXIT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Plays the recorded moves again, printing the field every turn
+int play_replay(options_t options, Map map) {
+  Replay replay = load_replay(options.replay_path);
+  if (replay == NULL) return EXIT_FAILURE;
+
+  if (get_replay_map_hash(replay) != get_map_hash(map)) {
+    fprintf(stderr, "WARNING: Replay was not recorded in this map\n");
+  }
+
+  contextual_strategy_t attacker_strategy = ATTACKER_REPLAY_STRATEGY(replay);
+  contextual_strategy_t defender_strategy = DEFENDER_REPLAY_STRATEGY(replay);
+
+  Game game = map == NULL
+    ? new_contextual_game(options.field_dimension,
+                          STANDARD_MAX_NUMBER_SPIES,
+                          attacker_strategy,
+                          defender_strategy)
+    : new_contextual_game_from_map(map,
+                                   STANDARD_MAX_NUMBER_SPIES,
+                                   attacker_strategy,
+                                   defender_strategy);
+
+  if (game == NULL) {
+    delete_replay(replay);
+    return EXIT_FAILURE;
+  }
+
+  // Games are recorded until they are over, so all turns are played
+  seed_game(game, options.seed);
+  set_game_render_mode(game, options.render_mode);
+  set_game_async_rendering(game, options.is_rendering_async,
+                           options.is_dropping_frames);
+  tablebase_oracle_t oracle = { .tablebase = options.oracle };
+  add_oracle_observer(game, &oracle);
+
+  play_game(game, get_replay_number_turns(replay));
+
+  delete_game(game);
+  if (oracle.tablebase != NULL) print_tablebase_score(oracle.score);
+  delete_replay(replay);
+
+  return EXIT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// With a map, the teams are its players, up to the sizes of the options
+int play_team_games(options_t options, Map map) {
+  statistics_t statistics = NULL_STATISTICS;
+  contextual_strategy_t defender_strategy = DEFENDER_CONTEXTUAL_STRATEGY;
+
+  uint64_t start_time = get_monotonic_time();
+
+  for (size_t k = 0; k < options.number_games; k++) {
+    TeamGame game = map == NULL
+      ? new_team_game(options.field_dimension,
+                      options.number_attackers,
+                      options.number_defenders,
+                      STANDARD_MAX_NUMBER_SPIES,
+                      options.attacker_strategy,
+                      defender_strategy)
+      : new_team_game_from_map(map,
+                               options.number_attackers,
+                               options.number_defenders,
+                               STANDARD_MAX_NUMBER_SPIES,
+                               options.attacker_strategy,
+                               defender_strategy);
+    if (game == NULL) return EXIT_FAILURE;
+
+    seed_team_game(game, mix_seed(options.seed, k));
+    set_team_game_render_mode(game, options.render_mode);
+
+    game_result_t result = options.is_quiet
+      ? play_team_game_quietly(game, options.max_turns)
+      : play_team_game(game, options.max_turns);
+    add_result_to_statistics(&statistics, result);
+
+    delete_team_game(game);
+  }
+
+  statistics.elapsed_time = get_monotonic_time() - start_time;
+  if (options.number_games > 1 || options.is_quiet) {
+    print_statistics(statistics);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Does nothing without a tablebase
+bool add_oracle_observer(Game game, tablebase_oracle_t* oracle) {
+  if (oracle->tablebase == NULL) return false;
+  return add_game_observer(game, make_tablebase_observer(oracle));
+}
+
+/*----------------------------------------------------------------------------*/
+
+void print_statistics(statistics_t statistics) {
+  double games = statistics.games;
+  double seconds = statistics.elapsed_time / NANOSECONDS_PER_SECOND;
+
+  printf("Games:         %lu\n", statistics.games);
+  printf("Attacker wins: %lu (%.2f%%)\n",
+      statistics.attacker_wins, 100.0 * statistics.attacker_wins / games);
+  printf("Defender wins: %lu (%.2f%%)\n",
+      statistics.defender_wins, 100.0 * statistics.defender_wins / games);
+  printf("Draws:         %lu (%.2f%%)\n",
+      statistics.draws, 100.0 * statistics.draws / games);
+  printf("Cheats:        %lu\n", statistics.cheats);
+  printf("Timeouts:      %lu\n", statistics.timeouts);
+  printf("Mean turns:    %.2f\n", statistics.turns / games);
+  printf("Games/second:  %.0f\n", seconds > 0 ? games / seconds : 0.0);
+
+  tablebase_score_t score = statistics.score;
+  if (score.attacker_moves + score.defender_moves > 0) {
+    print_tablebase_score(score);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Mistakes are moves that made the outcome worse for their player
+void print_tablebase_score(tablebase_score_t score) {
+  printf("Attacker mistakes: %lu of %lu moves (%.2f%%)\n",
+      score.attacker_mistakes, score.attacker_moves,
+      score.attacker_moves > 0
+        ? 100.0 * score.attacker_mistakes / score.attacker_moves
+        : 0.0);
+  printf("Defender mistakes: %lu of %lu moves (%.2f%%)\n",
+      score.defender_mistakes, score.defender_moves,
+      score.defender_moves > 0
+        ? 100.0 * score.defender_mistakes / score.defender_moves
+        : 0.0);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void print_thread_statistics(statistics_t* thread_statistics,
+                             size_t number_threads) {
+  if (number_threads == 1) return;
+
+  for (size_t t = 0; t < number_threads; t++) {
+    statistics_t statistics = thread_statistics[t];
+    double games = statistics.games;
+    double seconds = statistics.elapsed_time / NANOSECONDS_PER_SECOND;
+
+    printf("Thread %3lu:    %lu games, %.0f games/second\n",
+        t, statistics.games, seconds > 0 ? games / seconds : 0.0);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void print_latencies(latencies_t latencies) {
+  printf("\nStrategy latency (ns):\n");
+  print_latency("Attacker", latencies.attacker);
+  print_latency("Defender", latencies.defender);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void print_latency(const char* player, Histogram latencies) {
+  printf("%s: %lu calls, p50 %lu, p99 %lu, p999 %lu, max %lu\n",
+      player, get_histogram_count(latencies),
+      get_histogram_percentile(latencies, 50.0),
+      get_histogram_percentile(latencies, 99.0),
+      get_histogram_percentile(latencies, 99.9),
+      get_histogram_max(latencies));
+}
+
+/*----------------------------------------------------------------------------*/
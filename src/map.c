@@ -1,7 +1,15 @@
 // Standard headers
 #include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // Internal headers
 #include "dimension.h"
@@ -9,47 +17,149 @@
 // Main header
 #include "map.h"
 
+// Macros
+#define NUMBER_SYMBOLS (UCHAR_MAX + 1)
+
+#define COMPILED_MAP_MAGIC "RGBM"
+#define COMPILED_MAP_VERSION 1
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
 /*----------------------------------------------------------------------------*/
 /*                        PRIVATE STRUCT IMPLEMENTATION                       */
 /*----------------------------------------------------------------------------*/
 
+/**
+ * Compiled maps start with this header, followed by the obstacle plane:
+ * one bit per cell in row-major order, packed in 64-bit words.
+ * All fields are in the byte order of the machine that compiled the map,
+ * and the header size keeps the plane aligned when the file is mapped.
+ * Players absent from the map have ULONG_MAX as their coordinates.
+ */
+struct compiled_map_header {
+  char magic[4];
+  uint32_t version;
+
+  uint64_t height;
+  uint64_t width;
+
+  uint64_t attacker_i;
+  uint64_t attacker_j;
+  uint64_t defender_i;
+  uint64_t defender_j;
+
+  uint64_t number_obstacles;
+  uint64_t hash;
+};
+typedef struct compiled_map_header compiled_map_header_t;
+
 struct map {
   dimension_t dimension;
-  char** grid;
+
+  // Counted while the map is read, with the first position of each symbol
+  size_t occurrences[NUMBER_SYMBOLS];
+  position_t first_positions[NUMBER_SYMBOLS];
+
+  // Compiled maps keep their file mapped and have no grid
+  const void* mapping;
+  size_t mapping_size;
+  const uint64_t* obstacles;
+  uint64_t hash;
+
+  // Row-major grid, allocated together with the map
+  char grid[];
 };
 
 /*----------------------------------------------------------------------------*/
 /*                          PRIVATE FUNCTIONS HEADERS                         */
 /*----------------------------------------------------------------------------*/
 
-dimension_t read_map_dimension_from_map_file(FILE* map_file);
-void read_map_grid_from_map_file(char** grid,
-                                 dimension_t dimension,
-                                 FILE* map_file);
-
-char** allocate_map_grid(dimension_t dimension);
-void free_map_grid(char** grid, dimension_t dimension);
+const char* read_map_dimension_from_map_text(const char* text,
+                                             const char* end,
+                                             dimension_t* dimension);
+const char* read_number_from_map_text(const char* text,
+                                      const char* end,
+                                      size_t* number);
+void read_map_grid_from_map_text(Map map, const char* text, const char* end);
+void count_map_line_symbols(Map map, size_t line);
+void warn_unknown_map_symbols(Map map);
+
+Map new_map_from_compiled_map(const char* map_path,
+                              const void* mapping,
+                              size_t size);
+bool is_compiled_map(const void* mapping, size_t size);
+position_t find_map_symbol(Map map, char symbol);
+size_t get_obstacle_plane_words(dimension_t dimension);
+uint64_t hash_map(Map map,
+                  const uint64_t* obstacles,
+                  position_t attacker,
+                  position_t defender);
+uint64_t hash_bytes(uint64_t hash, const void* bytes, size_t size);
 
 /*----------------------------------------------------------------------------*/
 /*                              PUBLIC FUNCTIONS                              */
 /*----------------------------------------------------------------------------*/
 
 Map new_map(const char* map_path) {
-  FILE* map_file = fopen(map_path, "r");
+  int map_file = open(map_path, O_RDONLY);
 
-  if (map_file == NULL) {
+  struct stat map_status;
+  if (map_file < 0 || fstat(map_file, &map_status) < 0) {
     fprintf(stderr, "ERROR: Could not open file %s\n", map_path);
+    if (map_file >= 0) close(map_file);
     return NULL;
   }
 
-  Map map = malloc(sizeof(*map));
+  size_t size = map_status.st_size;
+  const char* text = size > 0
+    ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, map_file, 0)
+    : MAP_FAILED;
+  close(map_file);
+
+  if (text == MAP_FAILED) {
+    fprintf(stderr, "ERROR: Map does not specify height and width\n");
+    return NULL;
+  }
+  if (is_compiled_map(text, size)) {
+    return new_map_from_compiled_map(map_path, text, size);
+  }
+
+  madvise((void*) text, size, MADV_SEQUENTIAL);
+
+  dimension_t dimension = NULL_DIMENSION;
+  const char* grid_text
+    = read_map_dimension_from_map_text(text, text + size, &dimension);
 
-  map->dimension = read_map_dimension_from_map_file(map_file);
-  map->grid = allocate_map_grid(map->dimension);
+  if (grid_text == NULL) {
+    fprintf(stderr, "ERROR: Map does not specify height and width\n");
+    munmap((void*) text, size);
+    return NULL;
+  }
+
+  size_t number_cells = dimension.height * dimension.width;
+  Map map = malloc(sizeof(*map) + number_cells * sizeof(*map->grid));
+
+  map->dimension = dimension;
+  memset(map->occurrences, 0, sizeof(map->occurrences));
+  for (size_t symbol = 0; symbol < NUMBER_SYMBOLS; symbol++) {
+    map->first_positions[symbol] = (position_t) INVALID_POSITION;
+  }
+
+  map->mapping = NULL;
+  map->mapping_size = 0;
+  map->obstacles = NULL;
+  map->hash = 0;
+
+  memset(map->grid, '\0', number_cells * sizeof(*map->grid));
+
+  read_map_grid_from_map_text(map, grid_text, text + size);
 
-  read_map_grid_from_map_file(map->grid, map->dimension, map_file);
+  munmap((void*) text, size);
 
-  fclose(map_file);
+  map->hash = hash_map(map, NULL,
+      get_map_symbol_position(map, 'A'),
+      get_map_symbol_position(map, 'D'));
 
   return map;
 }
@@ -59,8 +169,11 @@ Map new_map(const char* map_path) {
 void delete_map(Map map) {
   if (map == NULL) return;
 
-  free_map_grid(map->grid, map->dimension);
-  map->grid = NULL;
+  if (map->mapping != NULL) {
+    munmap((void*) map->mapping, map->mapping_size);
+    map->mapping = NULL;
+    map->obstacles = NULL;
+  }
 
   map->dimension = (dimension_t){ 0, 0 };
 
@@ -74,7 +187,7 @@ void print_map(Map map) {
 
   for (size_t i = 0; i < map->dimension.height; i++) {
     for (size_t j = 0; j < map->dimension.width; j++) {
-      putchar(map->grid[i][j]);
+      putchar(get_map_symbol(map, (position_t) { i, j }));
     }
     putchar('\n');
   }
@@ -92,99 +205,368 @@ dimension_t get_map_dimension(Map map) {
 
 char get_map_symbol(Map map, position_t position) {
   if (map == NULL) return '\0';
-  return map->grid[position.i][position.j];
+
+  size_t index = position.i * map->dimension.width + position.j;
+  if (map->obstacles == NULL) return map->grid[index];
+
+  if ((map->obstacles[index / 64] >> (index % 64)) & 1) return 'X';
+  if (equal_positions(position, map->first_positions['A'])) return 'A';
+  if (equal_positions(position, map->first_positions['D'])) return 'D';
+  return '.';
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_map_symbol_occurrences(Map map, char symbol) {
+  if (map == NULL) return 0;
+  return map->occurrences[(unsigned char) symbol];
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool has_map_exceeded_max_occurrences_of_symbol(Map map,
+                                                char symbol,
+                                                size_t max_occurrences) {
+  if (max_occurrences == 0) return false;
+  return get_map_symbol_occurrences(map, symbol) > max_occurrences;
+}
+
+/*----------------------------------------------------------------------------*/
+
+position_t get_map_symbol_position(Map map, char symbol) {
+  if (map == NULL) return (position_t) INVALID_POSITION;
+  return map->first_positions[(unsigned char) symbol];
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t get_map_hash(Map map) {
+  if (map == NULL) return 0;
+  return map->hash;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool write_compiled_map(Map map, const char* compiled_map_path) {
+  if (map == NULL) return false;
+
+  if (get_map_symbol_occurrences(map, 'A') > 1
+      || get_map_symbol_occurrences(map, 'D') > 1) {
+    fprintf(stderr, "ERROR: Compiled maps must have at most one attacker "
+        "and one defender\n");
+    return false;
+  }
+
+  size_t number_words = get_obstacle_plane_words(map->dimension);
+  uint64_t* obstacles = calloc(number_words, sizeof(*obstacles));
+
+  size_t index = 0;
+  for (size_t i = 0; i < map->dimension.height; i++) {
+    for (size_t j = 0; j < map->dimension.width; j++, index++) {
+      bool is_obstacle = get_map_symbol(map, (position_t) { i, j }) == 'X';
+      obstacles[index / 64] |= (uint64_t) is_obstacle << (index % 64);
+    }
+  }
+
+  position_t attacker = get_map_symbol_position(map, 'A');
+  position_t defender = get_map_symbol_position(map, 'D');
+
+  compiled_map_header_t header = {
+    .magic = COMPILED_MAP_MAGIC,
+    .version = COMPILED_MAP_VERSION,
+    .height = map->dimension.height,
+    .width = map->dimension.width,
+    .attacker_i = attacker.i,
+    .attacker_j = attacker.j,
+    .defender_i = defender.i,
+    .defender_j = defender.j,
+    .number_obstacles = get_map_symbol_occurrences(map, 'X'),
+    .hash = hash_map(map, obstacles, attacker, defender),
+  };
+
+  FILE* compiled_map_file = fopen(compiled_map_path, "wb");
+  if (compiled_map_file == NULL) {
+    fprintf(stderr, "ERROR: Could not open file %s\n", compiled_map_path);
+    free(obstacles);
+    return false;
+  }
+
+  bool is_written
+    = fwrite(&header, sizeof(header), 1, compiled_map_file) == 1
+    && fwrite(obstacles, sizeof(*obstacles), number_words,
+              compiled_map_file) == number_words;
+
+  if (fclose(compiled_map_file) != 0) is_written = false;
+  free(obstacles);
+
+  if (!is_written) {
+    fprintf(stderr, "ERROR: Could not write file %s\n", compiled_map_path);
+  }
+
+  return is_written;
 }
 
 /*----------------------------------------------------------------------------*/
 /*                             PRIVATE FUNCTIONS                              */
 /*----------------------------------------------------------------------------*/
 
-dimension_t read_map_dimension_from_map_file(FILE* map) {
-  dimension_t dimension = { 0, 0 };
+// Reads "height,width" followed by whitespace, returning where the grid
+// starts, or NULL if the header is invalid
+const char* read_map_dimension_from_map_text(const char* text,
+                                             const char* end,
+                                             dimension_t* dimension) {
+  text = read_number_from_map_text(text, end, &dimension->height);
+  if (text == NULL || text == end || *text != ',') return NULL;
 
-  int result = fscanf(map, "%lu,%lu\n",
-      &dimension.height, &dimension.width);
+  text = read_number_from_map_text(text+1, end, &dimension->width);
+  if (text == NULL) return NULL;
 
-  if (result == EOF) {
-    fprintf(stderr, "ERROR: Map does not specify height and width\n");
+  while (text < end && (*text == '\n' || *text == '\r'
+                        || *text == ' ' || *text == '\t')) {
+    text++;
+  }
+
+  return text;
+}
+
+/*----------------------------------------------------------------------------*/
+
+const char* read_number_from_map_text(const char* text,
+                                      const char* end,
+                                      size_t* number) {
+  const char* start = text;
+
+  *number = 0;
+  while (text < end && *text >= '0' && *text <= '9') {
+    *number = 10 * *number + (*text - '0');
+    text++;
   }
 
-  return dimension;
+  return text == start ? NULL : text;
 }
 
 /*----------------------------------------------------------------------------*/
 
-void read_map_grid_from_map_file(char** grid,
-                                 dimension_t dimension,
-                                 FILE* map_file) {
-  char symbol = EOF;
+void read_map_grid_from_map_text(Map map, const char* text, const char* end) {
+  dimension_t dimension = map->dimension;
   size_t line = 0;
-  size_t column = 0;
 
-  while ((symbol = getc(map_file)) != EOF) {
-    if (symbol == '\n') {
+  while (text < end) {
+    const char* newline = memchr(text, '\n', end - text);
+    const char* line_end = newline != NULL ? newline : end;
+    size_t columns = line_end - text;
+
+    if (line < dimension.height) {
       // Warns if newline is before width, ignores all characters after it
-      if (line < dimension.height && column < dimension.width) {
-        fprintf(stderr, "WARNING: Line %ld does not have at least %ld columns\n",
+      if (columns < dimension.width) {
+        fprintf(stderr,
+            "WARNING: Line %ld does not have at least %ld columns\n",
             line, dimension.width);
       }
 
-      if (line < dimension.height && column > dimension.width) {
+      if (columns > dimension.width) {
         fprintf(stderr, "WARNING: Line %ld has more than %ld columns\n",
             line, dimension.width);
       }
 
-      // Advances line, resets column
-      line++; column = 0;
+      memcpy(&map->grid[line * dimension.width], text,
+             columns < dimension.width ? columns : dimension.width);
 
-      continue;
+      count_map_line_symbols(map, line);
     }
 
-    // Regular symbol within height and width
-    if (line < dimension.height && column < dimension.width) {
-      grid[line][column] = symbol;
-    }
-
-    // Advances column
-    column++;
+    line++;
+    text = line_end + 1;
   }
 
   // Warns if there are less lines than height
   if (line < dimension.height) {
     fprintf(stderr, "WARNING: Map does not have at least %ld lines\n",
-        dimension.width);
+        dimension.height);
   }
+
+  warn_unknown_map_symbols(map);
 }
 
 /*----------------------------------------------------------------------------*/
 
-// Allocate map's grid as C-matrix in the heap
-char** allocate_map_grid(dimension_t dimension) {
-  char** grid = malloc(dimension.height * sizeof(*grid));
-  for (size_t i = 0; i < dimension.height; i++) {
-    grid[i] = malloc(dimension.width * sizeof(*grid[i]));
-    for (size_t j = 0; j < dimension.width; j++) {
-      grid[i][j] = '\0';
+// Counts the symbols of a line just copied to the grid, which is still
+// in the cache, and finds where each symbol appears for the first time
+void count_map_line_symbols(Map map, size_t line) {
+  size_t width = map->dimension.width;
+  const unsigned char* row
+    = (const unsigned char*) &map->grid[line * width];
+
+  size_t line_occurrences[NUMBER_SYMBOLS] = { 0 };
+  for (size_t j = 0; j < width; j++) {
+    line_occurrences[row[j]]++;
+  }
+
+  for (size_t symbol = 0; symbol < NUMBER_SYMBOLS; symbol++) {
+    if (line_occurrences[symbol] == 0) continue;
+
+    if (map->occurrences[symbol] == 0) {
+      const unsigned char* first = memchr(row, symbol, width);
+      map->first_positions[symbol]
+        = (position_t) { line, (size_t) (first - row) };
     }
+
+    map->occurrences[symbol] += line_occurrences[symbol];
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void warn_unknown_map_symbols(Map map) {
+  size_t number_cells = map->dimension.height * map->dimension.width;
+
+  size_t known_occurrences = 0;
+  for (const char* symbol = MAP_SYMBOLS; *symbol != '\0'; symbol++) {
+    known_occurrences += map->occurrences[(unsigned char) *symbol];
   }
 
-  return grid;
+  // Missing cells are also counted as unknown symbols
+  if (known_occurrences < number_cells) {
+    fprintf(stderr, "WARNING: Map has %ld unknown symbols, "
+        "which are treated as empty cells\n",
+        number_cells - known_occurrences);
+  }
 }
 
 /*----------------------------------------------------------------------------*/
 
-// Free map's grid as C-matrix in the heap
-void free_map_grid(char** grid, dimension_t dimension) {
-  // This function should always be used on an initialized map,
-  // whose grid was allocated previously
-  assert(grid != NULL);
+// Uses the mapped file directly: only the header is read, and the
+// obstacle plane is accessed in place by get_map_symbol
+Map new_map_from_compiled_map(const char* map_path,
+                              const void* mapping,
+                              size_t size) {
+  const compiled_map_header_t* header = mapping;
+  dimension_t dimension = { header->height, header->width };
+
+  size_t number_words = get_obstacle_plane_words(dimension);
+  if (header->version != COMPILED_MAP_VERSION
+      || size != sizeof(*header) + number_words * sizeof(uint64_t)) {
+    fprintf(stderr, "ERROR: Compiled map %s is corrupted or "
+        "has an unsupported version\n", map_path);
+    munmap((void*) mapping, size);
+    return NULL;
+  }
+
+  Map map = malloc(sizeof(*map));
+
+  map->dimension = dimension;
+  memset(map->occurrences, 0, sizeof(map->occurrences));
+  for (size_t symbol = 0; symbol < NUMBER_SYMBOLS; symbol++) {
+    map->first_positions[symbol] = (position_t) INVALID_POSITION;
+  }
+
+  map->mapping = mapping;
+  map->mapping_size = size;
+  map->obstacles = (const uint64_t*) (header + 1);
+  map->hash = header->hash;
+
+  position_t attacker = { header->attacker_i, header->attacker_j };
+  position_t defender = { header->defender_i, header->defender_j };
+
+  size_t number_players = 0;
+  if (attacker.i != ULONG_MAX) {
+    map->occurrences['A'] = 1;
+    map->first_positions['A'] = attacker;
+    number_players++;
+  }
+
+  if (defender.i != ULONG_MAX) {
+    map->occurrences['D'] = 1;
+    map->first_positions['D'] = defender;
+    number_players++;
+  }
+
+  size_t number_cells = dimension.height * dimension.width;
+  map->occurrences['X'] = header->number_obstacles;
+  map->occurrences['.']
+    = number_cells - header->number_obstacles - number_players;
+
+  map->first_positions['X'] = find_map_symbol(map, 'X');
+  map->first_positions['.'] = find_map_symbol(map, '.');
+
+  return map;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool is_compiled_map(const void* mapping, size_t size) {
+  return size >= sizeof(compiled_map_header_t)
+    && memcmp(mapping, COMPILED_MAP_MAGIC, 4) == 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+position_t find_map_symbol(Map map, char symbol) {
+  if (map->occurrences[(unsigned char) symbol] == 0) {
+    return (position_t) INVALID_POSITION;
+  }
+
+  for (size_t i = 0; i < map->dimension.height; i++) {
+    for (size_t j = 0; j < map->dimension.width; j++) {
+      position_t position = { i, j };
+      if (get_map_symbol(map, position) == symbol) return position;
+    }
+  }
+
+  return (position_t) INVALID_POSITION;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_obstacle_plane_words(dimension_t dimension) {
+  return (dimension.height * dimension.width + 63) / 64;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// FNV-1a hash of the dimension, the player positions and the obstacle
+// plane, so a map has the same hash as text or compiled
+uint64_t hash_map(Map map,
+                  const uint64_t* obstacles,
+                  position_t attacker,
+                  position_t defender) {
+  uint64_t fields[] = {
+    map->dimension.height, map->dimension.width,
+    attacker.i, attacker.j, defender.i, defender.j,
+  };
+
+  uint64_t hash = hash_bytes(FNV_OFFSET_BASIS, fields, sizeof(fields));
+
+  size_t number_words = get_obstacle_plane_words(map->dimension);
+  for (size_t word = 0; word < number_words; word++) {
+    uint64_t obstacle_word = 0;
+
+    if (obstacles != NULL) {
+      obstacle_word = obstacles[word];
+    } else {
+      size_t last = word == number_words - 1
+        ? map->dimension.height * map->dimension.width - 64 * word
+        : 64;
+      for (size_t bit = 0; bit < last; bit++) {
+        uint64_t is_obstacle = map->grid[64 * word + bit] == 'X';
+        obstacle_word |= is_obstacle << bit;
+      }
+    }
+
+    hash = hash_bytes(hash, &obstacle_word, sizeof(obstacle_word));
+  }
+
+  return hash;
+}
+
+/*----------------------------------------------------------------------------*/
 
-  for (size_t i = 0; i < dimension.height; i++) {
-    free(grid[i]);
-    grid[i] = NULL;
+uint64_t hash_bytes(uint64_t hash, const void* bytes, size_t size) {
+  const unsigned char* byte = bytes;
+  for (size_t k = 0; k < size; k++) {
+    hash = (hash ^ byte[k]) * FNV_PRIME;
   }
-  free(grid);
-  grid = NULL;
+  return hash;
 }
 
 /*----------------------------------------------------------------------------*/
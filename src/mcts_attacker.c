@@ -0,0 +1,479 @@
+// Standard headers
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Internal headers
+#include "direction.h"
+#include "distance_field.h"
+#include "game.h"
+#include "map.h"
+#include "position.h"
+#include "random.h"
+#include "spy.h"
+#include "timer.h"
+
+// Main header
+#include "mcts_attacker.h"
+
+// Macros
+#define NUMBER_MOVES 9
+#define NO_NODE UINT32_MAX
+#define EXPLORATION 1.4
+#define CHASE_PROBABILITY 0.25 // How often the modeled defender chases
+#define GOAL_BIAS 0.5 // How often rollouts move towards the goal
+#define DISCOUNT 0.99 // Per turn, so that earlier goals are preferred
+#define TIME_CHECK_INTERVAL 64 // Rollouts between readings of the clock
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+static const direction_t moves[NUMBER_MOVES] = {
+  DIR_STAY, DIR_UP, DIR_UP_RIGHT, DIR_RIGHT, DIR_DOWN_RIGHT,
+  DIR_DOWN, DIR_DOWN_LEFT, DIR_LEFT, DIR_UP_LEFT,
+};
+
+/**
+ * A node is reached by a sequence of attacker moves from the root.
+ * Defender moves are sampled in every rollout, so nodes keep the
+ * mean reward over all defender moves that were tried.
+ */
+struct node {
+  uint32_t visits;
+  double reward;
+  uint32_t children[NUMBER_MOVES];
+};
+typedef struct node node_t;
+
+/**
+ * A searcher builds its own tree in its own simulated game,
+ * so searchers run in parallel without sharing anything.
+ */
+struct searcher {
+  Game game;
+  game_snapshot_t root;
+  rng_t rng;
+
+  node_t* nodes;
+  size_t number_nodes;
+  size_t max_number_nodes;
+
+  // Nodes visited by the current rollout
+  uint32_t* path;
+
+  size_t number_rollouts;
+  size_t rollout_depth;
+  DistanceField distance_field;
+  uint64_t stop_time;
+};
+typedef struct searcher searcher_t;
+
+struct mcts_attacker_context {
+  mcts_parameters_t parameters;
+
+  // Only deleted with the context if it was not given in the parameters
+  DistanceField distance_field;
+  bool owns_distance_field;
+
+  bool has_spied;
+  position_t defender_belief;
+
+  size_t number_searchers;
+  searcher_t searchers[];
+};
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+Game new_simulated_game(const mcts_parameters_t* parameters);
+void update_defender_belief(struct mcts_attacker_context* context,
+                            Spy defender_spy);
+direction_t chase(position_t chaser, position_t target);
+
+void run_searchers(struct mcts_attacker_context* context);
+void* run_searcher(void* searcher);
+void search_rollout(searcher_t* searcher);
+uint32_t select_child(searcher_t* searcher, uint32_t node);
+uint32_t new_node(searcher_t* searcher);
+direction_t model_defender_move(searcher_t* searcher);
+direction_t sample_rollout_move(searcher_t* searcher);
+double evaluate_game(searcher_t* searcher, bool* is_over);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+void* new_mcts_attacker_context(const void* parameters) {
+  mcts_parameters_t mcts_parameters = parameters != NULL
+    ? *(const mcts_parameters_t*) parameters
+    : (mcts_parameters_t) DEFAULT_MCTS_PARAMETERS;
+
+  size_t number_searchers = mcts_parameters.number_threads;
+  if (number_searchers == 0) number_searchers = 1;
+  if (number_searchers > MCTS_MAX_THREADS) number_searchers = MCTS_MAX_THREADS;
+
+  struct mcts_attacker_context* context = malloc(
+      sizeof(*context) + number_searchers * sizeof(*context->searchers));
+
+  context->parameters = mcts_parameters;
+  context->number_searchers = number_searchers;
+
+  // Games in the same map should share its distance field
+  context->owns_distance_field = mcts_parameters.distance_field == NULL;
+  context->distance_field = context->owns_distance_field
+    ? mcts_parameters.map != NULL
+      ? new_distance_field(mcts_parameters.map)
+      : new_bordered_distance_field(mcts_parameters.field_dimension)
+    : mcts_parameters.distance_field;
+
+  // Each rollout adds at most one node to the tree of its searcher
+  size_t rollouts_per_searcher
+    = (mcts_parameters.number_rollouts + number_searchers-1)
+      / number_searchers;
+
+  for (size_t s = 0; s < number_searchers; s++) {
+    searcher_t* searcher = &context->searchers[s];
+    searcher->game = new_simulated_game(&mcts_parameters);
+    searcher->max_number_nodes = rollouts_per_searcher + 1;
+    searcher->nodes
+      = malloc(searcher->max_number_nodes * sizeof(*searcher->nodes));
+    searcher->path = malloc(
+        (mcts_parameters.rollout_depth + 1) * sizeof(*searcher->path));
+    searcher->number_rollouts = rollouts_per_searcher;
+    searcher->rollout_depth = mcts_parameters.rollout_depth;
+    searcher->distance_field = context->distance_field;
+  }
+
+  reset_mcts_attacker_context(context, 0);
+
+  return context;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void reset_mcts_attacker_context(void* mcts_attacker_context, uint64_t seed) {
+  struct mcts_attacker_context* context = mcts_attacker_context;
+
+  context->has_spied = false;
+  context->defender_belief = (position_t) INVALID_POSITION;
+
+  for (size_t s = 0; s < context->number_searchers; s++) {
+    context->searchers[s].rng = new_rng(mix_seed(seed, s));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_mcts_attacker_context(void* mcts_attacker_context) {
+  struct mcts_attacker_context* context = mcts_attacker_context;
+  if (context == NULL) return;
+
+  for (size_t s = 0; s < context->number_searchers; s++) {
+    delete_game(context->searchers[s].game);
+    free(context->searchers[s].nodes);
+    free(context->searchers[s].path);
+  }
+
+  if (context->owns_distance_field) {
+    delete_distance_field(context->distance_field);
+  }
+
+  free(context);
+}
+
+/*----------------------------------------------------------------------------*/
+
+direction_t execute_mcts_attacker_strategy(void* mcts_attacker_context,
+                                           position_t attacker_position,
+                                           Spy defender_spy) {
+  struct mcts_attacker_context* context = mcts_attacker_context;
+
+  update_defender_belief(context, defender_spy);
+
+  // Threads do not see the deadline of this call, so they are given
+  // an absolute time to stop, with a margin to join them
+  uint64_t remaining_time = get_strategy_remaining_time();
+  uint64_t stop_time = remaining_time == UINT64_MAX
+    ? UINT64_MAX
+    : get_monotonic_time() + remaining_time / 4 * 3;
+
+  for (size_t s = 0; s < context->number_searchers; s++) {
+    searcher_t* searcher = &context->searchers[s];
+    if (searcher->game == NULL) return (direction_t) DIR_STAY;
+
+    // Only the positions of the root matter, as simulated games
+    // never use their spies nor their clocks
+    searcher->root = snapshot_game(searcher->game);
+    searcher->root.attacker_position = attacker_position;
+    searcher->root.defender_position = context->defender_belief;
+    searcher->stop_time = stop_time;
+  }
+
+  run_searchers(context);
+
+  uint64_t visits[NUMBER_MOVES] = { 0 };
+  for (size_t s = 0; s < context->number_searchers; s++) {
+    searcher_t* searcher = &context->searchers[s];
+    if (searcher->number_nodes == 0) continue;
+
+    node_t* root = &searcher->nodes[0];
+    for (size_t m = 0; m < NUMBER_MOVES; m++) {
+      if (root->children[m] == NO_NODE) continue;
+      visits[m] += searcher->nodes[root->children[m]].visits;
+    }
+  }
+
+  size_t best_move = 0;
+  for (size_t m = 1; m < NUMBER_MOVES; m++) {
+    if (visits[m] > visits[best_move]) best_move = m;
+  }
+
+  return moves[best_move];
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+// Simulated games only move their players with make_game_move(),
+// so they do not need strategies
+Game new_simulated_game(const mcts_parameters_t* parameters) {
+  if (parameters->map != NULL) {
+    return new_game_from_map(parameters->map, 1, NULL, NULL);
+  }
+
+  return new_game(parameters->field_dimension, 1, NULL, NULL);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The only spy is used in the first turn. Predicting where the defender
+// went from there made searches worse, as defenders often wait for the
+// attacker, so rollouts start from the spied position and leave the
+// uncertainty to the moves of the modeled defender
+void update_defender_belief(struct mcts_attacker_context* context,
+                            Spy defender_spy) {
+  if (context->has_spied) return;
+
+  context->defender_belief = get_spy_position(defender_spy);
+  context->has_spied = true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+direction_t chase(position_t chaser, position_t target) {
+  direction_t direction = {
+    .i = (target.i > chaser.i) - (target.i < chaser.i),
+    .j = (target.j > chaser.j) - (target.j < chaser.j),
+  };
+
+  return direction;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Root parallelization: the first searcher runs in the calling thread
+void run_searchers(struct mcts_attacker_context* context) {
+  pthread_t threads[MCTS_MAX_THREADS];
+  bool has_thread[MCTS_MAX_THREADS] = { false };
+
+  for (size_t s = 1; s < context->number_searchers; s++) {
+    has_thread[s] = pthread_create(&threads[s], NULL,
+                                   run_searcher, &context->searchers[s]) == 0;
+    if (!has_thread[s]) run_searcher(&context->searchers[s]);
+  }
+
+  run_searcher(&context->searchers[0]);
+
+  for (size_t s = 1; s < context->number_searchers; s++) {
+    if (has_thread[s]) pthread_join(threads[s], NULL);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* run_searcher(void* searcher) {
+  searcher_t* self = searcher;
+
+  self->number_nodes = 0;
+  new_node(self);
+
+  for (size_t r = 0; r < self->number_rollouts; r++) {
+    if (r % TIME_CHECK_INTERVAL == 0 && self->stop_time != UINT64_MAX
+        && get_monotonic_time() >= self->stop_time) {
+      break;
+    }
+
+    search_rollout(self);
+  }
+
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Descends the tree until a new node is added or the game is over,
+// plays random moves from there and updates the nodes in the path
+void search_rollout(searcher_t* searcher) {
+  Game game = searcher->game;
+  restore_game(game, searcher->root);
+
+  uint32_t* path = searcher->path;
+  size_t path_length = 0;
+  path[path_length++] = 0;
+
+  bool is_over = false;
+  double reward = 0;
+  size_t depth = 0;
+
+  // Selection and expansion
+  bool has_expanded = false;
+  while (!has_expanded && depth < searcher->rollout_depth) {
+    uint32_t node = path[path_length-1];
+    size_t number_nodes = searcher->number_nodes;
+
+    size_t move = select_child(searcher, node);
+    if (move == NUMBER_MOVES) break;
+
+    has_expanded = searcher->number_nodes > number_nodes;
+    path[path_length++] = searcher->nodes[node].children[move];
+
+    make_game_move(game, moves[move], model_defender_move(searcher));
+    depth++;
+
+    reward = evaluate_game(searcher, &is_over);
+    if (is_over) break;
+  }
+
+  // Simulation
+  while (!is_over && depth < searcher->rollout_depth) {
+    make_game_move(game, sample_rollout_move(searcher),
+                   model_defender_move(searcher));
+    depth++;
+
+    reward = evaluate_game(searcher, &is_over);
+  }
+
+  // Backpropagation
+  reward *= pow(DISCOUNT, depth);
+  for (size_t k = 0; k < path_length; k++) {
+    node_t* node = &searcher->nodes[path[k]];
+    node->visits++;
+    node->reward += reward;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Returns the first move not tried yet, adding its node, or the move
+// with the best upper confidence bound. Returns NUMBER_MOVES if there
+// is no room for more nodes.
+uint32_t select_child(searcher_t* searcher, uint32_t node) {
+  for (size_t m = 0; m < NUMBER_MOVES; m++) {
+    if (searcher->nodes[node].children[m] != NO_NODE) continue;
+
+    uint32_t child = new_node(searcher);
+    if (child == NO_NODE) return NUMBER_MOVES;
+
+    searcher->nodes[node].children[m] = child;
+    return m;
+  }
+
+  node_t* parent = &searcher->nodes[node];
+  double log_visits = log(parent->visits);
+
+  size_t best_move = 0;
+  double best_bound = -INFINITY;
+  for (size_t m = 0; m < NUMBER_MOVES; m++) {
+    node_t* child = &searcher->nodes[parent->children[m]];
+
+    double bound = child->reward / child->visits
+      + EXPLORATION * sqrt(log_visits / child->visits);
+
+    if (bound > best_bound) {
+      best_bound = bound;
+      best_move = m;
+    }
+  }
+
+  return best_move;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint32_t new_node(searcher_t* searcher) {
+  if (searcher->number_nodes == searcher->max_number_nodes) return NO_NODE;
+
+  uint32_t index = searcher->number_nodes++;
+
+  node_t* node = &searcher->nodes[index];
+  node->visits = 0;
+  node->reward = 0;
+  for (size_t m = 0; m < NUMBER_MOVES; m++) node->children[m] = NO_NODE;
+
+  return index;
+}
+
+/*----------------------------------------------------------------------------*/
+
+direction_t model_defender_move(searcher_t* searcher) {
+  double chance = next_rng(&searcher->rng) / (double) UINT64_MAX;
+  if (chance >= CHASE_PROBABILITY) {
+    return moves[next_rng(&searcher->rng) % NUMBER_MOVES];
+  }
+
+  game_snapshot_t state = snapshot_game(searcher->game);
+  return chase(state.defender_position, state.attacker_position);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Moves towards the goal are those that reduce the distance to it,
+// which is a lookup in the distance field for each move
+direction_t sample_rollout_move(searcher_t* searcher) {
+  double chance = next_rng(&searcher->rng) / (double) UINT64_MAX;
+  if (chance < GOAL_BIAS) {
+    position_t position = snapshot_game(searcher->game).attacker_position;
+    uint32_t distance = get_goal_distance(searcher->distance_field, position);
+
+    size_t goal_moves[NUMBER_MOVES];
+    size_t number_goal_moves = 0;
+    for (size_t m = 0; m < NUMBER_MOVES; m++) {
+      position_t target = move_position(position, moves[m]);
+      if (get_goal_distance(searcher->distance_field, target) < distance) {
+        goal_moves[number_goal_moves++] = m;
+      }
+    }
+
+    if (number_goal_moves > 0) {
+      return moves[goal_moves[next_rng(&searcher->rng) % number_goal_moves]];
+    }
+  }
+
+  return moves[next_rng(&searcher->rng) % NUMBER_MOVES];
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Rewards are 1 for a goal, 0 for a capture and, while the game is not
+// over, half of how close the attacker is to the goal, by its distance
+double evaluate_game(searcher_t* searcher, bool* is_over) {
+  game_result_t result;
+  *is_over = is_game_over(searcher->game, &result);
+
+  if (*is_over) return result.winner == WINNER_ATTACKER ? 1.0 : 0.0;
+
+  position_t position = snapshot_game(searcher->game).attacker_position;
+  uint32_t distance = get_goal_distance(searcher->distance_field, position);
+  uint32_t max_distance = get_max_goal_distance(searcher->distance_field);
+
+  if (distance == UNREACHABLE_DISTANCE || max_distance == 0) return 0.0;
+  return 0.5 * (1.0 - (double) distance / max_distance);
+}
+
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,80 @@
+// Standard headers
+#include <stdint.h>
+#include <stdlib.h>
+
+// Main header
+#include "random.h"
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+uint64_t next_splitmix(uint64_t* state);
+uint64_t rotate_left(uint64_t x, int k);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+rng_t new_rng(uint64_t seed) {
+  rng_t rng;
+
+  // SplitMix64 spreads the seed so that no state is all zeros
+  for (int k = 0; k < 4; k++) {
+    rng.state[k] = next_splitmix(&seed);
+  }
+
+  return rng;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t next_rng(rng_t* rng) {
+  uint64_t* s = rng->state;
+
+  uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+
+  s[2] ^= t;
+  s[3] = rotate_left(s[3], 45);
+
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+int next_rng_int(rng_t* rng) {
+  // High bits have the best quality
+  return (int) ((next_rng(rng) >> 32) % ((uint64_t) RAND_MAX + 1));
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t mix_seed(uint64_t seed, uint64_t stream) {
+  uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+  return next_splitmix(&state);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+uint64_t next_splitmix(uint64_t* state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t rotate_left(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,214 @@
+// Standard headers
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Internal headers
+#include "dimension.h"
+#include "field.h"
+
+// Main header
+#include "renderer.h"
+
+// Macros
+#define MAX_HEADER_LENGTH 32
+#define MAX_CURSOR_MOVE_LENGTH 48 // "\033[" row ";" column "H"
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+struct renderer {
+  dimension_t dimension;
+  RenderMode mode;
+  int file_descriptor;
+
+  // Grids of the current and previous frames, as written by the field
+  char* grid;
+  char* previous_grid;
+  size_t grid_length;
+  bool has_previous_frame;
+
+  // Frame written to the file descriptor
+  char* frame;
+  size_t frame_capacity;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+void draw_frame(Renderer renderer, size_t turn);
+size_t build_full_frame(Renderer renderer, size_t turn);
+size_t build_diff_frame(Renderer renderer, size_t turn);
+void write_frame(Renderer renderer, size_t length);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+Renderer new_renderer(dimension_t dimension,
+                      RenderMode mode,
+                      int file_descriptor) {
+  Renderer renderer = malloc(sizeof(*renderer));
+  if (renderer == NULL) return NULL;
+
+  renderer->dimension = dimension;
+  renderer->mode = mode;
+  renderer->file_descriptor = file_descriptor;
+
+  // Same length as get_field_grid_length() for this dimension
+  renderer->grid_length = dimension.height * (2 * dimension.width + 2) + 1;
+  renderer->grid = malloc(renderer->grid_length);
+  renderer->previous_grid = malloc(renderer->grid_length);
+  renderer->has_previous_frame = false;
+
+  // In the worst case, a diff frame moves the cursor to every cell
+  size_t number_cells = dimension.height * dimension.width;
+  renderer->frame_capacity = mode == RENDER_DIFF
+    ? 2 * MAX_HEADER_LENGTH + renderer->grid_length
+      + number_cells * (MAX_CURSOR_MOVE_LENGTH + 1)
+    : MAX_HEADER_LENGTH + renderer->grid_length;
+  renderer->frame = malloc(renderer->frame_capacity);
+
+  if (renderer->grid == NULL || renderer->previous_grid == NULL
+      || renderer->frame == NULL) {
+    delete_renderer(renderer);
+    return NULL;
+  }
+
+  return renderer;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_renderer(Renderer renderer) {
+  if (renderer == NULL) return;
+
+  free(renderer->frame);
+  free(renderer->previous_grid);
+  free(renderer->grid);
+
+  free(renderer);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void render_field(Renderer renderer, Field field, size_t turn) {
+  if (renderer == NULL || field == NULL) return;
+  if (get_field_grid_length(field) != renderer->grid_length) return;
+
+  write_field_grid(field, renderer->grid);
+  draw_frame(renderer, turn);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The grid is written in place in the frame, which always has room for it
+void render_field_grid(Renderer renderer, Field field) {
+  if (renderer == NULL || field == NULL) return;
+  if (get_field_grid_length(field) != renderer->grid_length) return;
+
+  write_frame(renderer, write_field_grid(field, renderer->frame));
+}
+
+/*----------------------------------------------------------------------------*/
+
+void render_grid(Renderer renderer, const char* grid, size_t turn) {
+  if (renderer == NULL || grid == NULL) return;
+
+  memcpy(renderer->grid, grid, renderer->grid_length);
+  draw_frame(renderer, turn);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+void draw_frame(Renderer renderer, size_t turn) {
+  size_t length = renderer->mode == RENDER_DIFF && renderer->has_previous_frame
+    ? build_diff_frame(renderer, turn)
+    : build_full_frame(renderer, turn);
+
+  write_frame(renderer, length);
+
+  // Swaps the grids, so the current one becomes the previous
+  char* previous_grid = renderer->previous_grid;
+  renderer->previous_grid = renderer->grid;
+  renderer->grid = previous_grid;
+  renderer->has_previous_frame = true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t build_full_frame(Renderer renderer, size_t turn) {
+  char* cursor = renderer->frame;
+
+  // In diff mode, the first frame starts in a clear screen
+  if (renderer->mode == RENDER_DIFF) cursor += sprintf(cursor, "\033[2J\033[H");
+
+  cursor += sprintf(cursor, "Turn %ld\n", turn);
+
+  memcpy(cursor, renderer->grid, renderer->grid_length);
+  cursor += renderer->grid_length;
+
+  return cursor - renderer->frame;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The header is in the first line of the screen, and the cell (i, j)
+// in the line i+2 and the column 2*j+2 (both starting at 1)
+size_t build_diff_frame(Renderer renderer, size_t turn) {
+  char* cursor = renderer->frame;
+
+  cursor += sprintf(cursor, "\033[HTurn %ld\033[K", turn);
+
+  size_t row_length = 2 * renderer->dimension.width + 2;
+  for (size_t i = 0; i < renderer->dimension.height; i++) {
+    // Few cells change every turn, so most rows are skipped at once
+    const char* row = &renderer->grid[i * row_length];
+    const char* previous_row = &renderer->previous_grid[i * row_length];
+    if (memcmp(row, previous_row, row_length) == 0) continue;
+
+    for (size_t j = 0; j < renderer->dimension.width; j++) {
+      size_t offset = i * row_length + 2 * j + 1;
+      if (renderer->grid[offset] == renderer->previous_grid[offset]) continue;
+
+      cursor += sprintf(cursor, "\033[%lu;%luH", i+2, 2*j+2);
+      *cursor++ = renderer->grid[offset];
+    }
+  }
+
+  // Leaves the cursor after the grid, as a full frame would
+  cursor += sprintf(cursor, "\033[%lu;1H", renderer->dimension.height + 3);
+
+  return cursor - renderer->frame;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Anything already printed through stdio is flushed first, so the frame
+// keeps its place in the output
+void write_frame(Renderer renderer, size_t length) {
+  fflush(stdout);
+
+  const char* cursor = renderer->frame;
+  while (length > 0) {
+    ssize_t written = write(renderer->file_descriptor, cursor, length);
+
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+
+    cursor += written;
+    length -= written;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,412 @@
+// Standard headers
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Internal headers
+#include "direction.h"
+#include "spy.h"
+
+// Main header
+#include "replay.h"
+
+// Macros
+#define REPLAY_MAGIC "RGBR"
+#define REPLAY_VERSION 1
+#define REPLAY_INITIAL_CAPACITY 64
+#define MAX_SPY_USES_PER_TURN 15
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Replay files start with this header, followed by one byte per turn with
+ * the directions of the attacker (low nibble) and the defender (high
+ * nibble), and then by one 16-bit spy event for each spy use, which is
+ * the turn times 2 plus the ReplayPlayer who spied.
+ * All fields are in the byte order of the machine that saved the replay.
+ */
+struct replay_header {
+  char magic[4];
+  uint32_t version;
+  uint64_t map_hash;
+  uint32_t number_turns;
+  uint32_t number_spy_events;
+};
+typedef struct replay_header replay_header_t;
+
+struct replay {
+  uint64_t map_hash;
+
+  size_t number_turns;
+  size_t capacity;
+
+  // Set when a turn could not be recorded, so the replay is not saved
+  bool is_truncated;
+
+  // Both players in a byte per turn, attacker in the low nibble
+  uint8_t* directions;
+  uint8_t* spy_uses;
+};
+
+struct replay_context {
+  Replay replay;
+  ReplayPlayer player;
+  size_t turn;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+void* new_replay_context(const void* replay, ReplayPlayer player);
+
+uint8_t encode_direction(direction_t direction);
+direction_t decode_direction(uint8_t code);
+bool is_direction_code_valid(uint8_t code);
+
+uint8_t get_nibble(uint8_t byte, ReplayPlayer player);
+size_t count_replay_spy_events(Replay replay);
+bool read_replay_moves(Replay replay,
+                       replay_header_t header,
+                       FILE* replay_file);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+Replay new_replay(void) {
+  Replay replay = malloc(sizeof(*replay));
+
+  replay->map_hash = 0;
+  replay->number_turns = 0;
+  replay->capacity = REPLAY_INITIAL_CAPACITY;
+  replay->is_truncated = false;
+  replay->directions = malloc(replay->capacity * sizeof(*replay->directions));
+  replay->spy_uses = malloc(replay->capacity * sizeof(*replay->spy_uses));
+
+  return replay;
+}
+
+/*----------------------------------------------------------------------------*/
+
+Replay load_replay(const char* replay_path) {
+  FILE* replay_file = fopen(replay_path, "rb");
+
+  if (replay_file == NULL) {
+    fprintf(stderr, "ERROR: Could not open file %s\n", replay_path);
+    return NULL;
+  }
+
+  replay_header_t header;
+  bool is_valid = fread(&header, sizeof(header), 1, replay_file) == 1
+    && memcmp(header.magic, REPLAY_MAGIC, 4) == 0
+    && header.version == REPLAY_VERSION;
+
+  Replay replay = new_replay();
+  if (is_valid) replay->map_hash = header.map_hash;
+
+  is_valid = is_valid && read_replay_moves(replay, header, replay_file);
+
+  fclose(replay_file);
+
+  if (!is_valid) {
+    fprintf(stderr, "ERROR: Replay %s is corrupted or "
+        "has an unsupported version\n", replay_path);
+    delete_replay(replay);
+    return NULL;
+  }
+
+  return replay;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_replay(Replay replay) {
+  if (replay == NULL) return;
+
+  free(replay->spy_uses);
+  free(replay->directions);
+  replay->number_turns = 0;
+
+  free(replay);
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool save_replay(Replay replay, const char* replay_path) {
+  if (replay == NULL) return false;
+
+  if (replay->is_truncated) {
+    fprintf(stderr, "ERROR: Replay %s would be truncated after %zu turns\n",
+        replay_path, replay->number_turns);
+    return false;
+  }
+
+  FILE* replay_file = fopen(replay_path, "wb");
+  if (replay_file == NULL) {
+    fprintf(stderr, "ERROR: Could not open file %s\n", replay_path);
+    return false;
+  }
+
+  replay_header_t header = {
+    .magic = REPLAY_MAGIC,
+    .version = REPLAY_VERSION,
+    .map_hash = replay->map_hash,
+    .number_turns = replay->number_turns,
+    .number_spy_events = count_replay_spy_events(replay),
+  };
+
+  bool is_written = fwrite(&header, sizeof(header), 1, replay_file) == 1
+    && fwrite(replay->directions, sizeof(*replay->directions),
+              replay->number_turns, replay_file) == replay->number_turns;
+
+  for (size_t turn = 0; turn < replay->number_turns; turn++) {
+    for (ReplayPlayer player = REPLAY_ATTACKER;
+         player <= REPLAY_DEFENDER; player++) {
+      uint16_t spy_event = 2 * turn + player;
+      size_t spy_uses = get_nibble(replay->spy_uses[turn], player);
+
+      for (size_t k = 0; k < spy_uses; k++) {
+        is_written = is_written
+          && fwrite(&spy_event, sizeof(spy_event), 1, replay_file) == 1;
+      }
+    }
+  }
+
+  if (fclose(replay_file) != 0) is_written = false;
+
+  if (!is_written) {
+    fprintf(stderr, "ERROR: Could not write file %s\n", replay_path);
+  }
+
+  return is_written;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_replay_map_hash(Replay replay, uint64_t map_hash) {
+  if (replay == NULL) return;
+  replay->map_hash = map_hash;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t get_replay_map_hash(Replay replay) {
+  if (replay == NULL) return 0;
+  return replay->map_hash;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_replay_number_turns(Replay replay) {
+  if (replay == NULL) return 0;
+  return replay->number_turns;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool record_replay_turn(Replay replay,
+                        replay_move_t attacker_move,
+                        replay_move_t defender_move) {
+  if (replay == NULL) return false;
+
+  if (replay->number_turns == REPLAY_MAX_TURNS) {
+    replay->is_truncated = true;
+    return false;
+  }
+
+  if (replay->number_turns == replay->capacity) {
+    size_t capacity = 2 * replay->capacity;
+
+    uint8_t* directions = realloc(replay->directions,
+        capacity * sizeof(*replay->directions));
+    if (directions != NULL) replay->directions = directions;
+
+    uint8_t* spy_uses = realloc(replay->spy_uses,
+        capacity * sizeof(*replay->spy_uses));
+    if (spy_uses != NULL) replay->spy_uses = spy_uses;
+
+    if (directions == NULL || spy_uses == NULL) {
+      replay->is_truncated = true;
+      return false;
+    }
+    replay->capacity = capacity;
+  }
+
+  size_t attacker_spy_uses = attacker_move.spy_uses < MAX_SPY_USES_PER_TURN
+    ? attacker_move.spy_uses
+    : MAX_SPY_USES_PER_TURN;
+  size_t defender_spy_uses = defender_move.spy_uses < MAX_SPY_USES_PER_TURN
+    ? defender_move.spy_uses
+    : MAX_SPY_USES_PER_TURN;
+
+  size_t turn = replay->number_turns++;
+  replay->directions[turn] = encode_direction(attacker_move.direction)
+    | encode_direction(defender_move.direction) << 4;
+  replay->spy_uses[turn] = attacker_spy_uses | defender_spy_uses << 4;
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+replay_move_t get_replay_move(Replay replay,
+                              size_t turn,
+                              ReplayPlayer player) {
+  replay_move_t move = { DIR_STAY, 0 };
+  if (replay == NULL || turn >= replay->number_turns) return move;
+
+  move.direction = decode_direction(
+      get_nibble(replay->directions[turn], player));
+  move.spy_uses = get_nibble(replay->spy_uses[turn], player);
+
+  return move;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* new_attacker_replay_context(const void* replay) {
+  return new_replay_context(replay, REPLAY_ATTACKER);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void* new_defender_replay_context(const void* replay) {
+  return new_replay_context(replay, REPLAY_DEFENDER);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Replays have no random numbers, so the seed is ignored
+void reset_replay_context(void* replay_context, uint64_t seed) {
+  struct replay_context* context = replay_context;
+
+  (void) seed;
+  context->turn = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_replay_context(void* replay_context) {
+  free(replay_context);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Spies as many times as recorded, so cheating is replayed as well
+direction_t execute_replay_strategy(void* replay_context,
+                                    position_t position,
+                                    Spy opponent_spy) {
+  struct replay_context* context = replay_context;
+
+  (void) position;
+  replay_move_t move
+    = get_replay_move(context->replay, context->turn++, context->player);
+
+  for (size_t k = 0; k < move.spy_uses; k++) {
+    get_spy_position(opponent_spy);
+  }
+
+  return move.direction;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+void* new_replay_context(const void* replay, ReplayPlayer player) {
+  struct replay_context* context = malloc(sizeof(*context));
+
+  // Contexts only read the replay
+  context->replay = (Replay) replay;
+  context->player = player;
+  context->turn = 0;
+
+  return context;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Directions have components in { -1, 0, 1 }, so they have 9 codes
+uint8_t encode_direction(direction_t direction) {
+  return 3 * (direction.i + 1) + (direction.j + 1);
+}
+
+/*----------------------------------------------------------------------------*/
+
+direction_t decode_direction(uint8_t code) {
+  return (direction_t) { code / 3 - 1, code % 3 - 1 };
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool is_direction_code_valid(uint8_t code) {
+  return code < 9;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint8_t get_nibble(uint8_t byte, ReplayPlayer player) {
+  return player == REPLAY_ATTACKER ? byte & 0xF : byte >> 4;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t count_replay_spy_events(Replay replay) {
+  size_t number_spy_events = 0;
+
+  for (size_t turn = 0; turn < replay->number_turns; turn++) {
+    number_spy_events += get_nibble(replay->spy_uses[turn], REPLAY_ATTACKER);
+    number_spy_events += get_nibble(replay->spy_uses[turn], REPLAY_DEFENDER);
+  }
+
+  return number_spy_events;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool read_replay_moves(Replay replay,
+                       replay_header_t header,
+                       FILE* replay_file) {
+  for (size_t turn = 0; turn < header.number_turns; turn++) {
+    int byte = getc(replay_file);
+    if (byte == EOF) return false;
+
+    if (!is_direction_code_valid(get_nibble(byte, REPLAY_ATTACKER))
+        || !is_direction_code_valid(get_nibble(byte, REPLAY_DEFENDER))) {
+      return false;
+    }
+
+    replay_move_t attacker_move = { decode_direction(byte & 0xF), 0 };
+    replay_move_t defender_move = { decode_direction(byte >> 4), 0 };
+    if (!record_replay_turn(replay, attacker_move, defender_move)) {
+      return false;
+    }
+  }
+
+  for (size_t k = 0; k < header.number_spy_events; k++) {
+    uint16_t spy_event;
+    if (fread(&spy_event, sizeof(spy_event), 1, replay_file) != 1) {
+      return false;
+    }
+
+    size_t turn = spy_event / 2;
+    ReplayPlayer player = spy_event % 2;
+    if (turn >= replay->number_turns) return false;
+
+    // Spy uses of a player are in a nibble
+    uint8_t spy_uses = get_nibble(replay->spy_uses[turn], player);
+    if (spy_uses == MAX_SPY_USES_PER_TURN) continue;
+
+    replay->spy_uses[turn] += player == REPLAY_ATTACKER ? 1 : 1 << 4;
+  }
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,215 @@
+// Standard headers
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Internal headers
+#include "position.h"
+
+// Main header
+#include "spatial_hash.h"
+
+// Macros
+#define NO_ENTRY SIZE_MAX
+#define MIN_NUMBER_SLOTS 16
+
+#define BUCKET_ROW_MULTIPLIER 0x9E3779B97F4A7C15ULL
+#define BUCKET_COLUMN_MULTIPLIER 0xC2B2AE3D27D4EB4FULL
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Each slot of the table heads a doubly linked list of the entries whose
+ * bucket hashes to it, so entries move in constant time. Different
+ * buckets may share a slot, so queries check the bucket of each entry.
+ */
+struct spatial_hash {
+  size_t max_entries;
+  size_t number_slots;
+  size_t* heads;
+
+  // Indexed by entry, whose slot is NO_ENTRY if it is not in the hash
+  position_t* positions;
+  size_t* slots;
+  size_t* next;
+  size_t* previous;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+size_t get_bucket_slot(SpatialHash spatial_hash, size_t bucket_i,
+                       size_t bucket_j);
+void unlink_spatial_hash_entry(SpatialHash spatial_hash, size_t entry);
+bool is_within_radius(position_t center, position_t position, size_t radius);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+// The table has a power of two slots, at least two per entry
+SpatialHash new_spatial_hash(size_t max_entries) {
+  SpatialHash spatial_hash = malloc(sizeof(*spatial_hash));
+
+  size_t number_slots = MIN_NUMBER_SLOTS;
+  while (number_slots < 2 * max_entries) number_slots *= 2;
+
+  spatial_hash->max_entries = max_entries;
+  spatial_hash->number_slots = number_slots;
+  spatial_hash->heads = malloc(number_slots * sizeof(size_t));
+
+  spatial_hash->positions = malloc(max_entries * sizeof(position_t));
+  spatial_hash->slots = malloc(max_entries * sizeof(size_t));
+  spatial_hash->next = malloc(max_entries * sizeof(size_t));
+  spatial_hash->previous = malloc(max_entries * sizeof(size_t));
+
+  for (size_t slot = 0; slot < number_slots; slot++) {
+    spatial_hash->heads[slot] = NO_ENTRY;
+  }
+
+  for (size_t entry = 0; entry < max_entries; entry++) {
+    spatial_hash->slots[entry] = NO_ENTRY;
+  }
+
+  return spatial_hash;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_spatial_hash(SpatialHash spatial_hash) {
+  if (spatial_hash == NULL) return;
+
+  free(spatial_hash->previous);
+  free(spatial_hash->next);
+  free(spatial_hash->slots);
+  free(spatial_hash->positions);
+  free(spatial_hash->heads);
+  free(spatial_hash);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void insert_into_spatial_hash(SpatialHash spatial_hash,
+                              size_t entry,
+                              position_t position) {
+  if (spatial_hash == NULL || entry >= spatial_hash->max_entries) return;
+
+  size_t slot = get_bucket_slot(spatial_hash,
+                                position.i / SPATIAL_HASH_BUCKET_SIZE,
+                                position.j / SPATIAL_HASH_BUCKET_SIZE);
+
+  spatial_hash->positions[entry] = position;
+
+  // Entries that stay in the same slot keep their place in its list
+  if (spatial_hash->slots[entry] == slot) return;
+  unlink_spatial_hash_entry(spatial_hash, entry);
+
+  size_t head = spatial_hash->heads[slot];
+  if (head != NO_ENTRY) spatial_hash->previous[head] = entry;
+
+  spatial_hash->slots[entry] = slot;
+  spatial_hash->next[entry] = head;
+  spatial_hash->previous[entry] = NO_ENTRY;
+  spatial_hash->heads[slot] = entry;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void remove_from_spatial_hash(SpatialHash spatial_hash, size_t entry) {
+  if (spatial_hash == NULL || entry >= spatial_hash->max_entries) return;
+  unlink_spatial_hash_entry(spatial_hash, entry);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Each bucket around the center is visited once, even if it shares its
+// slot with another one, by skipping the entries of other buckets
+size_t query_spatial_hash(SpatialHash spatial_hash,
+                          position_t center,
+                          size_t radius,
+                          size_t* found_entries,
+                          size_t max_found) {
+  if (spatial_hash == NULL || found_entries == NULL) return 0;
+
+  // Unsigned positions cannot go below zero, but may go beyond any field
+  size_t first_i = center.i >= radius ? center.i - radius : 0;
+  size_t first_j = center.j >= radius ? center.j - radius : 0;
+  size_t last_i = center.i + radius;
+  size_t last_j = center.j + radius;
+
+  size_t number_found = 0;
+
+  for (size_t bucket_i = first_i / SPATIAL_HASH_BUCKET_SIZE;
+       bucket_i <= last_i / SPATIAL_HASH_BUCKET_SIZE; bucket_i++) {
+    for (size_t bucket_j = first_j / SPATIAL_HASH_BUCKET_SIZE;
+         bucket_j <= last_j / SPATIAL_HASH_BUCKET_SIZE; bucket_j++) {
+      size_t slot = get_bucket_slot(spatial_hash, bucket_i, bucket_j);
+
+      size_t entry = spatial_hash->heads[slot];
+      for (; entry != NO_ENTRY; entry = spatial_hash->next[entry]) {
+        position_t position = spatial_hash->positions[entry];
+
+        bool is_in_bucket = position.i / SPATIAL_HASH_BUCKET_SIZE == bucket_i
+          && position.j / SPATIAL_HASH_BUCKET_SIZE == bucket_j;
+        if (!is_in_bucket) continue;
+        if (!is_within_radius(center, position, radius)) continue;
+
+        if (number_found == max_found) return number_found;
+        found_entries[number_found++] = entry;
+      }
+    }
+  }
+
+  return number_found;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+size_t get_bucket_slot(SpatialHash spatial_hash, size_t bucket_i,
+                       size_t bucket_j) {
+  uint64_t key = bucket_i * BUCKET_ROW_MULTIPLIER
+    ^ bucket_j * BUCKET_COLUMN_MULTIPLIER;
+
+  // The high bits of the products are the best mixed
+  return (key ^ (key >> 32)) & (spatial_hash->number_slots - 1);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void unlink_spatial_hash_entry(SpatialHash spatial_hash, size_t entry) {
+  size_t slot = spatial_hash->slots[entry];
+  if (slot == NO_ENTRY) return;
+
+  size_t next = spatial_hash->next[entry];
+  size_t previous = spatial_hash->previous[entry];
+
+  if (next != NO_ENTRY) spatial_hash->previous[next] = previous;
+  if (previous != NO_ENTRY) {
+    spatial_hash->next[previous] = next;
+  } else {
+    spatial_hash->heads[slot] = next;
+  }
+
+  spatial_hash->slots[entry] = NO_ENTRY;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool is_within_radius(position_t center, position_t position, size_t radius) {
+  size_t distance_i = position.i > center.i
+    ? position.i - center.i
+    : center.i - position.i;
+  size_t distance_j = position.j > center.j
+    ? position.j - center.j
+    : center.j - position.j;
+
+  return distance_i <= radius && distance_j <= radius;
+}
+
+/*----------------------------------------------------------------------------*/
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 
 // Internal headers
+#include "arena.h"
 #include "item.h"
 
 // Main header
@@ -16,15 +17,30 @@ struct spy {
   size_t number_uses;
 };
 
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+void init_spy(Spy spy, Item item);
+
 /*----------------------------------------------------------------------------*/
 /*                              PUBLIC FUNCTIONS                              */
 /*----------------------------------------------------------------------------*/
 
 Spy new_spy(Item item) {
   Spy spy = malloc(sizeof(*spy));
+  init_spy(spy, item);
 
-  spy->item = item;
-  spy->number_uses = 0;
+  return spy;
+}
+
+/*----------------------------------------------------------------------------*/
+
+Spy new_spy_in_arena(Arena arena, Item item) {
+  Spy spy = allocate_from_arena(arena, sizeof(*spy));
+  if (spy == NULL) return NULL;
+
+  init_spy(spy, item);
 
   return spy;
 }
@@ -42,6 +58,14 @@ void delete_spy(Spy spy) {
 
 /*----------------------------------------------------------------------------*/
 
+void reset_spy(Spy spy) {
+  if (spy == NULL) return;
+
+  spy->number_uses = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
 position_t get_spy_position(Spy spy) {
   if (spy == NULL) return (position_t) INVALID_POSITION;
 
@@ -58,3 +82,22 @@ size_t get_spy_number_uses(Spy spy) {
 
   return spy->number_uses;
 }
+
+/*----------------------------------------------------------------------------*/
+
+void set_spy_number_uses(Spy spy, size_t number_uses) {
+  if (spy == NULL) return;
+
+  spy->number_uses = number_uses;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+void init_spy(Spy spy, Item item) {
+  spy->item = item;
+  spy->number_uses = 0;
+}
+
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,919 @@
+// Standard headers
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Internal headers
+#include "dimension.h"
+#include "direction.h"
+#include "game.h"
+#include "map.h"
+#include "position.h"
+#include "replay.h"
+
+// Main header
+#include "tablebase.h"
+
+// Macros
+#define TABLEBASE_MAGIC "RGBT"
+#define TABLEBASE_VERSION 2
+
+#define OBSTACLE_SYMBOL 'X'
+#define NUMBER_DIRECTIONS 9
+#define NUMBER_SIDES 2
+
+// Entries have the outcome in their 2 high bits and the distance
+// in the other 14, so unresolved states are draws at the largest one
+#define DISTANCE_BITS 14
+#define DISTANCE_MASK ((1u << DISTANCE_BITS) - 1)
+#define MAX_DISTANCE (DISTANCE_MASK - 1)
+#define UNRESOLVED_ENTRY DISTANCE_MASK
+
+#define MAKE_ENTRY(outcome, distance) \
+  ((uint16_t) ((outcome) << DISTANCE_BITS | (distance)))
+#define ENTRY_OUTCOME(entry) ((Outcome) ((entry) >> DISTANCE_BITS))
+#define ENTRY_DISTANCE(entry) ((size_t) ((entry) & DISTANCE_MASK))
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+// Staying comes first, so it is preferred among equally good moves
+static const direction_t directions[NUMBER_DIRECTIONS] = {
+  DIR_STAY, DIR_UP, DIR_UP_RIGHT, DIR_RIGHT, DIR_DOWN_RIGHT,
+  DIR_DOWN, DIR_DOWN_LEFT, DIR_LEFT, DIR_UP_LEFT,
+};
+
+/**
+ * Saved tablebases start with this header, followed by the entries,
+ * indexed by ((player_to_move * cells) + attacker_cell) * cells
+ * + defender_cell, where cells are numbered in row-major order.
+ * All fields are in the byte order of the machine that saved it.
+ */
+struct tablebase_header {
+  char magic[4];
+  uint32_t version;
+
+  uint64_t height;
+  uint64_t width;
+
+  uint64_t map_hash;
+  uint64_t max_distance;
+  uint64_t is_bordered_field;
+};
+typedef struct tablebase_header tablebase_header_t;
+
+struct tablebase {
+  dimension_t dimension;
+  size_t number_cells;
+  uint64_t map_hash;
+  size_t max_distance;
+  bool is_bordered_field;
+
+  // Loaded tablebases keep their file mapped and have no allocated entries
+  const void* mapping;
+  size_t mapping_size;
+  const uint16_t* entries;
+  uint16_t* allocated_entries;
+};
+
+/**
+ * What the threads that generate a tablebase share. Moves of each cell
+ * are precomputed, with blocked moves replaced by staying in place.
+ */
+struct generation {
+  Tablebase tablebase;
+  Map map;
+  size_t* moves;
+
+  // Held until every thread is started, so the barrier and the ranges
+  // of states are only for the threads that could be started
+  pthread_mutex_t start_lock;
+  pthread_barrier_t barrier;
+  atomic_size_t number_resolved;
+  size_t distance;
+  bool is_done;
+
+  // Any thread may fail while the others are resolving their states
+  atomic_bool has_failed;
+};
+typedef struct generation generation_t;
+
+/**
+ * A generator resolves the states in [first_state, last_state),
+ * collecting the new entries of each distance before writing them,
+ * so no thread reads an entry while another writes it.
+ */
+struct generator {
+  generation_t* generation;
+  size_t first_state;
+  size_t last_state;
+
+  size_t* resolved_states;
+  uint16_t* resolved_entries;
+  size_t number_resolved;
+  size_t capacity;
+};
+typedef struct generator generator_t;
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+Tablebase allocate_tablebase(dimension_t dimension);
+size_t* new_tablebase_moves(Map map, dimension_t dimension);
+void mark_invalid_states(Tablebase tablebase, Map map);
+bool is_map_bordered_field(Map map);
+
+void* run_generator(void* generator);
+bool resolve_terminal_states(generator_t* generator);
+void resolve_states(generator_t* generator, size_t distance);
+uint16_t resolve_state(generation_t* generation,
+                       size_t state,
+                       size_t distance);
+void add_resolved_state(generator_t* generator, size_t state, uint16_t entry);
+
+size_t get_successor_state(const size_t* moves,
+                           size_t number_cells,
+                           size_t state,
+                           size_t direction);
+size_t get_state_index(Tablebase tablebase,
+                       position_t attacker_position,
+                       position_t defender_position,
+                       ReplayPlayer player_to_move);
+int rank_outcome(Outcome outcome, ReplayPlayer player);
+
+Tablebase new_tablebase_from_mapping(const char* tablebase_path,
+                                     const void* mapping,
+                                     size_t size);
+
+void start_scoring_game(void* oracle, Game game);
+void score_turn(void* oracle,
+                Game game,
+                size_t turn,
+                replay_move_t attacker_move,
+                replay_move_t defender_move);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+// Retrograde analysis: terminal states are resolved at distance zero and,
+// at each distance k, a state is resolved if its player has a move to
+// a win resolved before k, or if all its moves lead to losses resolved
+// before k. When nothing is resolved, the remaining states are draws.
+Tablebase generate_tablebase(Map map, size_t number_threads) {
+  if (map == NULL) return NULL;
+
+  if (get_map_symbol_occurrences(map, 'A') == 0
+      || get_map_symbol_occurrences(map, 'D') == 0) {
+    fprintf(stderr, "ERROR: Tablebases need maps with an attacker "
+        "and a defender\n");
+    return NULL;
+  }
+
+  if (number_threads == 0) number_threads = 1;
+
+  dimension_t dimension = get_map_dimension(map);
+  Tablebase tablebase = allocate_tablebase(dimension);
+  if (tablebase == NULL) {
+    fprintf(stderr, "ERROR: Could not allocate tablebase\n");
+    return NULL;
+  }
+
+  tablebase->map_hash = get_map_hash(map);
+  tablebase->is_bordered_field = is_map_bordered_field(map);
+  mark_invalid_states(tablebase, map);
+
+  size_t* moves = new_tablebase_moves(map, dimension);
+  generator_t* generators = calloc(number_threads, sizeof(*generators));
+  pthread_t* threads = malloc(number_threads * sizeof(*threads));
+
+  if (moves == NULL || generators == NULL || threads == NULL) {
+    fprintf(stderr, "ERROR: Could not allocate tablebase\n");
+    free(threads);
+    free(generators);
+    free(moves);
+    delete_tablebase(tablebase);
+    return NULL;
+  }
+
+  generation_t generation = {
+    .tablebase = tablebase,
+    .map = map,
+    .moves = moves,
+    .distance = 0,
+    .is_done = false,
+  };
+  atomic_init(&generation.number_resolved, 0);
+  atomic_init(&generation.has_failed, false);
+  pthread_mutex_init(&generation.start_lock, NULL);
+
+  size_t number_states = NUMBER_SIDES * tablebase->number_cells
+    * tablebase->number_cells;
+
+  for (size_t t = 0; t < number_threads; t++) {
+    generators[t].generation = &generation;
+  }
+
+  // The current thread works as the first generator, and the others
+  // are the threads that could be started
+  pthread_mutex_lock(&generation.start_lock);
+
+  size_t number_generators = 1;
+  for (size_t t = 1; t < number_threads; t++) {
+    bool is_started = pthread_create(&threads[number_generators], NULL,
+        run_generator, &generators[number_generators]) == 0;
+    if (is_started) number_generators++;
+  }
+
+  pthread_barrier_init(&generation.barrier, NULL, number_generators);
+  for (size_t t = 0; t < number_generators; t++) {
+    generators[t].first_state = t * number_states / number_generators;
+    generators[t].last_state = (t+1) * number_states / number_generators;
+  }
+
+  pthread_mutex_unlock(&generation.start_lock);
+  run_generator(&generators[0]);
+
+  for (size_t t = 1; t < number_generators; t++) {
+    pthread_join(threads[t], NULL);
+  }
+
+  for (size_t t = 0; t < number_generators; t++) {
+    free(generators[t].resolved_states);
+    free(generators[t].resolved_entries);
+  }
+
+  pthread_barrier_destroy(&generation.barrier);
+  pthread_mutex_destroy(&generation.start_lock);
+  free(threads);
+  free(generators);
+  free(moves);
+
+  if (atomic_load(&generation.has_failed)) {
+    delete_tablebase(tablebase);
+    return NULL;
+  }
+
+  for (size_t state = 0; state < number_states; state++) {
+    if (tablebase->allocated_entries[state] == UNRESOLVED_ENTRY) {
+      tablebase->allocated_entries[state] = MAKE_ENTRY(OUTCOME_DRAW, 0);
+    }
+  }
+
+  // The last distance resolved nothing
+  tablebase->max_distance
+    = generation.distance > 0 ? generation.distance - 1 : 0;
+
+  return tablebase;
+}
+
+/*----------------------------------------------------------------------------*/
+
+Tablebase load_tablebase(const char* tablebase_path) {
+  int tablebase_file = open(tablebase_path, O_RDONLY);
+
+  struct stat tablebase_status;
+  if (tablebase_file < 0 || fstat(tablebase_file, &tablebase_status) < 0) {
+    fprintf(stderr, "ERROR: Could not open file %s\n", tablebase_path);
+    if (tablebase_file >= 0) close(tablebase_file);
+    return NULL;
+  }
+
+  size_t size = tablebase_status.st_size;
+  const void* mapping = size >= sizeof(tablebase_header_t)
+    ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, tablebase_file, 0)
+    : MAP_FAILED;
+  close(tablebase_file);
+
+  if (mapping == MAP_FAILED) {
+    fprintf(stderr, "ERROR: Tablebase %s is corrupted\n", tablebase_path);
+    return NULL;
+  }
+
+  return new_tablebase_from_mapping(tablebase_path, mapping, size);
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool save_tablebase(Tablebase tablebase, const char* tablebase_path) {
+  if (tablebase == NULL) return false;
+
+  tablebase_header_t header = {
+    .magic = TABLEBASE_MAGIC,
+    .version = TABLEBASE_VERSION,
+    .height = tablebase->dimension.height,
+    .width = tablebase->dimension.width,
+    .map_hash = tablebase->map_hash,
+    .max_distance = tablebase->max_distance,
+    .is_bordered_field = tablebase->is_bordered_field,
+  };
+
+  FILE* tablebase_file = fopen(tablebase_path, "wb");
+  if (tablebase_file == NULL) {
+    fprintf(stderr, "ERROR: Could not open file %s\n", tablebase_path);
+    return false;
+  }
+
+  size_t number_entries = NUMBER_SIDES * tablebase->number_cells
+    * tablebase->number_cells;
+
+  bool is_written
+    = fwrite(&header, sizeof(header), 1, tablebase_file) == 1
+    && fwrite(tablebase->entries, sizeof(*tablebase->entries),
+              number_entries, tablebase_file) == number_entries;
+
+  if (fclose(tablebase_file) != 0) is_written = false;
+
+  if (!is_written) {
+    fprintf(stderr, "ERROR: Could not write file %s\n", tablebase_path);
+  }
+
+  return is_written;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_tablebase(Tablebase tablebase) {
+  if (tablebase == NULL) return;
+
+  if (tablebase->mapping != NULL) {
+    munmap((void*) tablebase->mapping, tablebase->mapping_size);
+  }
+
+  free(tablebase->allocated_entries);
+  free(tablebase);
+}
+
+/*----------------------------------------------------------------------------*/
+
+dimension_t get_tablebase_dimension(Tablebase tablebase) {
+  if (tablebase == NULL) return (dimension_t) NULL_DIMENSION;
+  return tablebase->dimension;
+}
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t get_tablebase_map_hash(Tablebase tablebase) {
+  if (tablebase == NULL) return 0;
+  return tablebase->map_hash;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_tablebase_max_distance(Tablebase tablebase) {
+  if (tablebase == NULL) return 0;
+  return tablebase->max_distance;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool is_tablebase_of_bordered_field(Tablebase tablebase) {
+  if (tablebase == NULL) return false;
+  return tablebase->is_bordered_field;
+}
+
+/*----------------------------------------------------------------------------*/
+
+tablebase_entry_t probe_tablebase(Tablebase tablebase,
+                                  position_t attacker_position,
+                                  position_t defender_position,
+                                  ReplayPlayer player_to_move) {
+  tablebase_entry_t invalid_entry = { OUTCOME_INVALID, 0 };
+  if (tablebase == NULL) return invalid_entry;
+
+  size_t state = get_state_index(tablebase, attacker_position,
+                                 defender_position, player_to_move);
+  if (state == SIZE_MAX) return invalid_entry;
+
+  uint16_t entry = tablebase->entries[state];
+  return (tablebase_entry_t) { ENTRY_OUTCOME(entry), ENTRY_DISTANCE(entry) };
+}
+
+/*----------------------------------------------------------------------------*/
+
+direction_t get_tablebase_move(Tablebase tablebase,
+                               position_t attacker_position,
+                               position_t defender_position,
+                               ReplayPlayer player_to_move) {
+  direction_t best_direction = DIR_STAY;
+  if (tablebase == NULL) return best_direction;
+
+  tablebase_entry_t best_entry = { OUTCOME_INVALID, 0 };
+  int best_rank = -1;
+
+  for (size_t k = 0; k < NUMBER_DIRECTIONS; k++) {
+    position_t attacker = attacker_position;
+    position_t defender = defender_position;
+
+    // Blocked moves stay in place, as in the game
+    position_t* mover
+      = player_to_move == REPLAY_ATTACKER ? &attacker : &defender;
+    position_t* opponent
+      = player_to_move == REPLAY_ATTACKER ? &defender : &attacker;
+    position_t target = move_position(*mover, directions[k]);
+    if (!equal_positions(target, *opponent)) *mover = target;
+
+    ReplayPlayer next_player = player_to_move == REPLAY_ATTACKER
+      ? REPLAY_DEFENDER
+      : REPLAY_ATTACKER;
+    tablebase_entry_t entry
+      = probe_tablebase(tablebase, attacker, defender, next_player);
+    if (entry.outcome == OUTCOME_INVALID) continue;
+
+    // Among wins the fastest is best, among losses the slowest
+    int rank = rank_outcome(entry.outcome, player_to_move);
+    bool is_better = rank > best_rank
+      || (rank == best_rank && rank == 2
+          && entry.distance < best_entry.distance)
+      || (rank == best_rank && rank == 0
+          && entry.distance > best_entry.distance);
+
+    if (is_better) {
+      best_direction = directions[k];
+      best_entry = entry;
+      best_rank = rank;
+    }
+  }
+
+  return best_direction;
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_observer_t make_tablebase_observer(tablebase_oracle_t* oracle) {
+  game_observer_t observer = {
+    .on_game_start = start_scoring_game,
+    .on_spy_use = NULL,
+    .on_turn_end = score_turn,
+    .on_game_end = NULL,
+    .data = oracle,
+  };
+
+  return observer;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void merge_tablebase_scores(tablebase_score_t* score,
+                            tablebase_score_t other) {
+  if (score == NULL) return;
+
+  score->attacker_moves += other.attacker_moves;
+  score->attacker_mistakes += other.attacker_mistakes;
+  score->defender_moves += other.defender_moves;
+  score->defender_mistakes += other.defender_mistakes;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+Tablebase allocate_tablebase(dimension_t dimension) {
+  size_t number_cells = dimension.height * dimension.width;
+  size_t number_states = NUMBER_SIDES * number_cells * number_cells;
+
+  uint16_t* entries = malloc(number_states * sizeof(*entries));
+  if (entries == NULL) return NULL;
+
+  Tablebase tablebase = malloc(sizeof(*tablebase));
+
+  tablebase->dimension = dimension;
+  tablebase->number_cells = number_cells;
+  tablebase->map_hash = 0;
+  tablebase->max_distance = 0;
+  tablebase->is_bordered_field = false;
+  tablebase->mapping = NULL;
+  tablebase->mapping_size = 0;
+  tablebase->entries = entries;
+  tablebase->allocated_entries = entries;
+
+  for (size_t state = 0; state < number_states; state++) {
+    entries[state] = UNRESOLVED_ENTRY;
+  }
+
+  return tablebase;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Moves into obstacles or beyond the limits of the field stay in place
+size_t* new_tablebase_moves(Map map, dimension_t dimension) {
+  size_t number_cells = dimension.height * dimension.width;
+  size_t* moves = malloc(number_cells * NUMBER_DIRECTIONS * sizeof(*moves));
+  if (moves == NULL) return NULL;
+
+  size_t cell = 0;
+  for (size_t i = 0; i < dimension.height; i++) {
+    for (size_t j = 0; j < dimension.width; j++, cell++) {
+      for (size_t k = 0; k < NUMBER_DIRECTIONS; k++) {
+        position_t target = move_position((position_t) { i, j },
+                                          directions[k]);
+
+        bool is_blocked = target.i >= dimension.height
+          || target.j >= dimension.width
+          || get_map_symbol(map, target) == OBSTACLE_SYMBOL;
+
+        moves[cell * NUMBER_DIRECTIONS + k] = is_blocked
+          ? cell
+          : target.i * dimension.width + target.j;
+      }
+    }
+  }
+
+  return moves;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void mark_invalid_states(Tablebase tablebase, Map map) {
+  size_t number_cells = tablebase->number_cells;
+  size_t width = tablebase->dimension.width;
+
+  bool* is_obstacle = malloc(number_cells * sizeof(*is_obstacle));
+  for (size_t cell = 0; cell < number_cells; cell++) {
+    position_t position = { cell / width, cell % width };
+    is_obstacle[cell] = get_map_symbol(map, position) == OBSTACLE_SYMBOL;
+  }
+
+  uint16_t invalid_entry = MAKE_ENTRY(OUTCOME_INVALID, 0);
+
+  for (size_t side = 0; side < NUMBER_SIDES; side++) {
+    for (size_t attacker = 0; attacker < number_cells; attacker++) {
+      uint16_t* row = tablebase->allocated_entries
+        + (side * number_cells + attacker) * number_cells;
+
+      if (is_obstacle[attacker]) {
+        for (size_t defender = 0; defender < number_cells; defender++) {
+          row[defender] = invalid_entry;
+        }
+        continue;
+      }
+
+      for (size_t defender = 0; defender < number_cells; defender++) {
+        if (is_obstacle[defender] || defender == attacker) {
+          row[defender] = invalid_entry;
+        }
+      }
+    }
+  }
+
+  free(is_obstacle);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Whether the map has obstacles exactly on its borders, like the field
+// of games without a map
+bool is_map_bordered_field(Map map) {
+  dimension_t dimension = get_map_dimension(map);
+
+  for (size_t i = 0; i < dimension.height; i++) {
+    for (size_t j = 0; j < dimension.width; j++) {
+      bool is_border = i == 0 || j == 0
+        || i == dimension.height-1 || j == dimension.width-1;
+      bool is_obstacle
+        = get_map_symbol(map, (position_t) { i, j }) == OBSTACLE_SYMBOL;
+      if (is_border != is_obstacle) return false;
+    }
+  }
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Every distance takes three barriers: after the states are resolved,
+// after their entries are written and after one thread checks if any
+// of them was resolved. Generators start once their range is known.
+void* run_generator(void* generator) {
+  generator_t* self = generator;
+  generation_t* generation = self->generation;
+
+  pthread_mutex_lock(&generation->start_lock);
+  pthread_mutex_unlock(&generation->start_lock);
+
+  bool has_failed = !resolve_terminal_states(self);
+
+  for (size_t distance = 0; ; distance++) {
+    if (distance > 0) resolve_states(self, distance);
+    pthread_barrier_wait(&generation->barrier);
+
+    uint16_t* entries = generation->tablebase->allocated_entries;
+    for (size_t k = 0; k < self->number_resolved; k++) {
+      entries[self->resolved_states[k]] = self->resolved_entries[k];
+    }
+    atomic_fetch_add(&generation->number_resolved, self->number_resolved);
+    if (has_failed) atomic_store(&generation->has_failed, true);
+
+    if (pthread_barrier_wait(&generation->barrier)
+        == PTHREAD_BARRIER_SERIAL_THREAD) {
+      size_t number_resolved = atomic_load(&generation->number_resolved);
+      atomic_store(&generation->number_resolved, 0);
+
+      generation->distance = distance;
+      generation->is_done = number_resolved == 0
+        || atomic_load(&generation->has_failed);
+
+      if (!generation->is_done && distance == MAX_DISTANCE) {
+        fprintf(stderr, "ERROR: Tablebase has distances beyond %u\n",
+            MAX_DISTANCE);
+        atomic_store(&generation->has_failed, true);
+        generation->is_done = true;
+      }
+    }
+
+    pthread_barrier_wait(&generation->barrier);
+    if (generation->is_done) break;
+  }
+
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Games are over only after both players move, when the attacker is
+// about to move again. Each thread asks its own Game, so terminal
+// states follow exactly the same rules as the games that are played.
+bool resolve_terminal_states(generator_t* self) {
+  generation_t* generation = self->generation;
+  Tablebase tablebase = generation->tablebase;
+  size_t number_cells = tablebase->number_cells;
+  size_t width = tablebase->dimension.width;
+
+  self->number_resolved = 0;
+
+  Game game = new_game_from_map(generation->map, 1, NULL, NULL);
+  if (game == NULL) return false;
+
+  game_snapshot_t snapshot = snapshot_game(game);
+
+  size_t last_state = self->last_state < number_cells * number_cells
+    ? self->last_state
+    : number_cells * number_cells;
+
+  for (size_t state = self->first_state; state < last_state; state++) {
+    if (tablebase->entries[state] != UNRESOLVED_ENTRY) continue;
+
+    size_t attacker = state / number_cells;
+    size_t defender = state % number_cells;
+    snapshot.attacker_position
+      = (position_t) { attacker / width, attacker % width };
+    snapshot.defender_position
+      = (position_t) { defender / width, defender % width };
+    restore_game(game, snapshot);
+
+    game_result_t result = NULL_GAME_RESULT;
+    if (!is_game_over(game, &result)) continue;
+
+    Outcome outcome = result.winner == WINNER_ATTACKER
+      ? OUTCOME_ATTACKER_WINS
+      : OUTCOME_DEFENDER_WINS;
+    add_resolved_state(self, state, MAKE_ENTRY(outcome, 0));
+  }
+
+  delete_game(game);
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void resolve_states(generator_t* self, size_t distance) {
+  self->number_resolved = 0;
+
+  for (size_t state = self->first_state; state < self->last_state; state++) {
+    if (self->generation->tablebase->entries[state] != UNRESOLVED_ENTRY) {
+      continue;
+    }
+
+    uint16_t entry = resolve_state(self->generation, state, distance);
+    if (entry != UNRESOLVED_ENTRY) add_resolved_state(self, state, entry);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Entries resolved at this distance are ignored, so the result does not
+// depend on which of them were already written
+uint16_t resolve_state(generation_t* generation,
+                       size_t state,
+                       size_t distance) {
+  Tablebase tablebase = generation->tablebase;
+  size_t number_cells = tablebase->number_cells;
+
+  bool is_attacker_to_move = state < number_cells * number_cells;
+  Outcome win = is_attacker_to_move
+    ? OUTCOME_ATTACKER_WINS
+    : OUTCOME_DEFENDER_WINS;
+  Outcome loss = is_attacker_to_move
+    ? OUTCOME_DEFENDER_WINS
+    : OUTCOME_ATTACKER_WINS;
+
+  bool are_all_losses = true;
+
+  for (size_t k = 0; k < NUMBER_DIRECTIONS; k++) {
+    size_t successor
+      = get_successor_state(generation->moves, number_cells, state, k);
+    uint16_t entry = tablebase->entries[successor];
+
+    bool is_resolved = entry != UNRESOLVED_ENTRY
+      && ENTRY_DISTANCE(entry) < distance;
+
+    if (is_resolved && ENTRY_OUTCOME(entry) == win) {
+      return MAKE_ENTRY(win, distance);
+    }
+    if (!is_resolved || ENTRY_OUTCOME(entry) != loss) are_all_losses = false;
+  }
+
+  return are_all_losses ? MAKE_ENTRY(loss, distance) : UNRESOLVED_ENTRY;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void add_resolved_state(generator_t* self, size_t state, uint16_t entry) {
+  if (self->number_resolved == self->capacity) {
+    self->capacity = self->capacity == 0 ? 1024 : 2 * self->capacity;
+    self->resolved_states = realloc(self->resolved_states,
+        self->capacity * sizeof(*self->resolved_states));
+    self->resolved_entries = realloc(self->resolved_entries,
+        self->capacity * sizeof(*self->resolved_entries));
+  }
+
+  self->resolved_states[self->number_resolved] = state;
+  self->resolved_entries[self->number_resolved] = entry;
+  self->number_resolved++;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The player to move leaves the state and the other player moves next.
+// Moving into the cell of the opponent is blocked, as in the game
+size_t get_successor_state(const size_t* moves,
+                           size_t number_cells,
+                           size_t state,
+                           size_t direction) {
+  size_t side = state / (number_cells * number_cells);
+  size_t attacker = state / number_cells % number_cells;
+  size_t defender = state % number_cells;
+
+  if (side == REPLAY_ATTACKER) {
+    size_t target = moves[attacker * NUMBER_DIRECTIONS + direction];
+    if (target != defender) attacker = target;
+  } else {
+    size_t target = moves[defender * NUMBER_DIRECTIONS + direction];
+    if (target != attacker) defender = target;
+  }
+
+  size_t next_side = side == REPLAY_ATTACKER
+    ? REPLAY_DEFENDER
+    : REPLAY_ATTACKER;
+
+  return (next_side * number_cells + attacker) * number_cells + defender;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Returns SIZE_MAX for positions beyond the limits of the field
+size_t get_state_index(Tablebase tablebase,
+                       position_t attacker_position,
+                       position_t defender_position,
+                       ReplayPlayer player_to_move) {
+  dimension_t dimension = tablebase->dimension;
+
+  if (attacker_position.i >= dimension.height
+      || attacker_position.j >= dimension.width
+      || defender_position.i >= dimension.height
+      || defender_position.j >= dimension.width) {
+    return SIZE_MAX;
+  }
+
+  size_t attacker = attacker_position.i * dimension.width
+    + attacker_position.j;
+  size_t defender = defender_position.i * dimension.width
+    + defender_position.j;
+  size_t side = player_to_move == REPLAY_ATTACKER ? 0 : 1;
+
+  return (side * tablebase->number_cells + attacker)
+    * tablebase->number_cells + defender;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Higher ranks are better for the player: 2 for wins, 1 for draws
+// and 0 for losses
+int rank_outcome(Outcome outcome, ReplayPlayer player) {
+  Outcome win = player == REPLAY_ATTACKER
+    ? OUTCOME_ATTACKER_WINS
+    : OUTCOME_DEFENDER_WINS;
+
+  if (outcome == win) return 2;
+  if (outcome == OUTCOME_DRAW) return 1;
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Uses the mapped file directly: only the header is read, and the
+// entries are accessed in place by probe_tablebase
+Tablebase new_tablebase_from_mapping(const char* tablebase_path,
+                                     const void* mapping,
+                                     size_t size) {
+  const tablebase_header_t* header = mapping;
+  dimension_t dimension = { header->height, header->width };
+
+  size_t number_cells = dimension.height * dimension.width;
+  size_t number_entries = NUMBER_SIDES * number_cells * number_cells;
+
+  if (memcmp(header->magic, TABLEBASE_MAGIC, 4) != 0
+      || header->version != TABLEBASE_VERSION
+      || size != sizeof(*header) + number_entries * sizeof(uint16_t)) {
+    fprintf(stderr, "ERROR: Tablebase %s is corrupted or "
+        "has an unsupported version\n", tablebase_path);
+    munmap((void*) mapping, size);
+    return NULL;
+  }
+
+  Tablebase tablebase = malloc(sizeof(*tablebase));
+
+  tablebase->dimension = dimension;
+  tablebase->number_cells = number_cells;
+  tablebase->map_hash = header->map_hash;
+  tablebase->max_distance = header->max_distance;
+  tablebase->is_bordered_field = header->is_bordered_field != 0;
+  tablebase->mapping = mapping;
+  tablebase->mapping_size = size;
+  tablebase->entries = (const uint16_t*) (header + 1);
+  tablebase->allocated_entries = NULL;
+
+  return tablebase;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void start_scoring_game(void* oracle, Game game) {
+  tablebase_oracle_t* self = oracle;
+
+  game_snapshot_t snapshot = snapshot_game(game);
+  self->attacker_position = snapshot.attacker_position;
+  self->defender_position = snapshot.defender_position;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The attacker moves first, so its move leads to the state with the new
+// attacker position, the old defender position and the defender to move.
+// A move is a mistake if that state is worse for the player than the one
+// it moved from, which has the best outcome of all its moves.
+void score_turn(void* oracle,
+                Game game,
+                size_t turn,
+                replay_move_t attacker_move,
+                replay_move_t defender_move) {
+  tablebase_oracle_t* self = oracle;
+  (void) turn;
+  (void) attacker_move;
+  (void) defender_move;
+
+  game_snapshot_t snapshot = snapshot_game(game);
+
+  tablebase_entry_t before = probe_tablebase(self->tablebase,
+      self->attacker_position, self->defender_position, REPLAY_ATTACKER);
+  tablebase_entry_t between = probe_tablebase(self->tablebase,
+      snapshot.attacker_position, self->defender_position, REPLAY_DEFENDER);
+  tablebase_entry_t after = probe_tablebase(self->tablebase,
+      snapshot.attacker_position, snapshot.defender_position,
+      REPLAY_ATTACKER);
+
+  if (before.outcome != OUTCOME_INVALID
+      && between.outcome != OUTCOME_INVALID) {
+    self->score.attacker_moves++;
+    if (rank_outcome(between.outcome, REPLAY_ATTACKER)
+        < rank_outcome(before.outcome, REPLAY_ATTACKER)) {
+      self->score.attacker_mistakes++;
+    }
+  }
+
+  if (between.outcome != OUTCOME_INVALID
+      && after.outcome != OUTCOME_INVALID) {
+    self->score.defender_moves++;
+    if (rank_outcome(after.outcome, REPLAY_DEFENDER)
+        < rank_outcome(between.outcome, REPLAY_DEFENDER)) {
+      self->score.defender_mistakes++;
+    }
+  }
+
+  self->attacker_position = snapshot.attacker_position;
+  self->defender_position = snapshot.defender_position;
+}
+
+/*----------------------------------------------------------------------------*/
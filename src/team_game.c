@@ -0,0 +1,611 @@
+// Standard headers
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Internal headers
+#include "field.h"
+#include "game.h"
+#include "item.h"
+#include "map.h"
+#include "random.h"
+#include "renderer.h"
+#include "spatial_hash.h"
+#include "spy.h"
+
+// Main header
+#include "team_game.h"
+
+// Macros
+#define ATTACKER_SYMBOL 'A'
+#define DEFENDER_SYMBOL 'D'
+#define OBSTACLE_SYMBOL 'X'
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * A player of a team, with its strategy context and its spy on an
+ * opponent. Captured players are no longer in the field.
+ */
+struct team_player {
+  Item item;
+  Spy opponent_spy;
+  void* context;
+  bool is_captured;
+};
+typedef struct team_player team_player_t;
+
+struct team_game {
+  Field field;
+  Item obstacle;
+
+  size_t max_number_spies;
+
+  contextual_strategy_t attacker_strategy;
+  contextual_strategy_t defender_strategy;
+
+  team_player_t* attackers;
+  size_t number_attackers;
+  team_player_t* defenders;
+  size_t number_defenders;
+
+  size_t number_captures;
+
+  // Where the defenders are, indexed by their number in the team
+  SpatialHash defender_positions;
+
+  RenderMode render_mode;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+TeamGame allocate_team_game(
+    dimension_t field_dimension,
+    size_t number_attackers,
+    size_t number_defenders,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy);
+
+team_player_t* new_team(size_t number_players,
+                        char symbol,
+                        contextual_strategy_t strategy);
+void spy_on_team(team_player_t* team,
+                 size_t number_players,
+                 team_player_t* opponents,
+                 size_t number_opponents);
+void delete_team(team_player_t* team,
+                 size_t number_players,
+                 contextual_strategy_t strategy);
+
+bool can_team_fit_in_field(dimension_t field_dimension,
+                           size_t number_players);
+size_t get_team_player_row(size_t player,
+                           size_t number_players,
+                           size_t field_height);
+void set_team_in_field(Field field,
+                       team_player_t* team,
+                       size_t number_players,
+                       size_t column);
+void set_teams_in_field_from_map(TeamGame game, Map map);
+void index_defender_positions(TeamGame game);
+
+game_result_t run_team_game(TeamGame game,
+                            size_t max_turns,
+                            Renderer renderer);
+void move_team(Field field,
+               team_player_t* team,
+               size_t number_players,
+               contextual_strategy_t strategy);
+bool is_team_game_over(TeamGame game, game_result_t* result);
+void capture_attackers(TeamGame game);
+
+bool has_team_cheated(team_player_t* team,
+                      size_t number_players,
+                      size_t max_number_spies);
+size_t count_team_spy_uses(team_player_t* team, size_t number_players);
+game_result_t make_team_game_result(TeamGame game,
+                                    Winner winner,
+                                    GameOverReason reason,
+                                    size_t turns);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+TeamGame new_team_game(
+    dimension_t field_dimension,
+    size_t number_attackers,
+    size_t number_defenders,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy) {
+  if (number_attackers > TEAM_MAX_PLAYERS
+      || number_defenders > TEAM_MAX_PLAYERS
+      || !can_team_fit_in_field(field_dimension, number_attackers)
+      || !can_team_fit_in_field(field_dimension, number_defenders)) {
+    fprintf(stderr, "ERROR: Teams of %lu and %lu players do not fit "
+        "in a %lux%lu field\n", number_attackers, number_defenders,
+        field_dimension.height, field_dimension.width);
+    return NULL;
+  }
+
+  TeamGame game = allocate_team_game(
+      field_dimension,
+      number_attackers,
+      number_defenders,
+      max_number_spies,
+      attacker_strategy,
+      defender_strategy);
+
+  set_team_in_field(game->field, game->attackers, number_attackers, 1);
+  set_team_in_field(game->field, game->defenders, number_defenders,
+                    field_dimension.width-2);
+  add_border_to_field(game->field, game->obstacle);
+
+  index_defender_positions(game);
+
+  return game;
+}
+
+/*----------------------------------------------------------------------------*/
+
+TeamGame new_team_game_from_map(
+    Map map,
+    size_t max_number_attackers,
+    size_t max_number_defenders,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy) {
+  if (map == NULL) return NULL;
+
+  char symbols[] = { ATTACKER_SYMBOL, DEFENDER_SYMBOL };
+  size_t max_occurrences[] = { max_number_attackers, max_number_defenders };
+
+  for (size_t k = 0; k < 2; k++) {
+    if (has_map_exceeded_max_occurrences_of_symbol(
+          map, symbols[k], max_occurrences[k])
+        || has_map_exceeded_max_occurrences_of_symbol(
+          map, symbols[k], TEAM_MAX_PLAYERS)) {
+      fprintf(stderr, "ERROR: Map exceeded max occurrences of symbol %c\n",
+          symbols[k]);
+      return NULL;
+    }
+
+    if (get_map_symbol_occurrences(map, symbols[k]) == 0) {
+      fprintf(stderr, "ERROR: Map has no symbol %c\n", symbols[k]);
+      return NULL;
+    }
+  }
+
+  TeamGame game = allocate_team_game(
+      get_map_dimension(map),
+      get_map_symbol_occurrences(map, ATTACKER_SYMBOL),
+      get_map_symbol_occurrences(map, DEFENDER_SYMBOL),
+      max_number_spies,
+      attacker_strategy,
+      defender_strategy);
+
+  set_teams_in_field_from_map(game, map);
+  index_defender_positions(game);
+
+  return game;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_team_game(TeamGame game) {
+  if (game == NULL) return;
+
+  delete_spatial_hash(game->defender_positions);
+  game->defender_positions = NULL;
+
+  delete_team(game->defenders, game->number_defenders,
+              game->defender_strategy);
+  game->defenders = NULL;
+
+  delete_team(game->attackers, game->number_attackers,
+              game->attacker_strategy);
+  game->attackers = NULL;
+
+  delete_item(game->obstacle);
+  game->obstacle = NULL;
+
+  delete_field(game->field);
+  game->field = NULL;
+
+  free(game);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Attackers take the even streams and defenders the odd ones
+void seed_team_game(TeamGame game, uint64_t seed) {
+  if (game == NULL) return;
+
+  if (game->attacker_strategy.reset_context != NULL) {
+    for (size_t k = 0; k < game->number_attackers; k++) {
+      game->attacker_strategy.reset_context(
+          game->attackers[k].context, mix_seed(seed, 2*k));
+    }
+  }
+
+  if (game->defender_strategy.reset_context != NULL) {
+    for (size_t k = 0; k < game->number_defenders; k++) {
+      game->defender_strategy.reset_context(
+          game->defenders[k].context, mix_seed(seed, 2*k + 1));
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+Field get_team_game_field(TeamGame game) {
+  if (game == NULL) return NULL;
+  return game->field;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t get_team_game_captures(TeamGame game) {
+  if (game == NULL) return 0;
+  return game->number_captures;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_team_game_render_mode(TeamGame game, RenderMode render_mode) {
+  if (game == NULL) return;
+
+  game->render_mode = render_mode;
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_result_t play_team_game(TeamGame game, size_t max_turns) {
+  if (game == NULL) return (game_result_t) NULL_GAME_RESULT;
+
+  Renderer renderer = new_renderer(get_field_dimension(game->field),
+                                   game->render_mode, STDOUT_FILENO);
+
+  game_result_t result = run_team_game(game, max_turns, renderer);
+
+  delete_renderer(renderer);
+  print_game_result(result, game->max_number_spies);
+  printf("Attackers captured: %lu of %lu\n",
+         game->number_captures, game->number_attackers);
+
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_result_t play_team_game_quietly(TeamGame game, size_t max_turns) {
+  if (game == NULL) return (game_result_t) NULL_GAME_RESULT;
+
+  return run_team_game(game, max_turns, NULL);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+// Players are created without a position, and the field is empty
+TeamGame allocate_team_game(
+    dimension_t field_dimension,
+    size_t number_attackers,
+    size_t number_defenders,
+    size_t max_number_spies,
+    contextual_strategy_t attacker_strategy,
+    contextual_strategy_t defender_strategy) {
+  TeamGame game = malloc(sizeof(*game));
+
+  game->field = new_field(field_dimension);
+  game->obstacle = new_item(OBSTACLE_SYMBOL, false);
+
+  game->max_number_spies = max_number_spies;
+
+  game->attacker_strategy = attacker_strategy;
+  game->defender_strategy = defender_strategy;
+
+  game->attackers
+    = new_team(number_attackers, ATTACKER_SYMBOL, attacker_strategy);
+  game->number_attackers = number_attackers;
+  game->defenders
+    = new_team(number_defenders, DEFENDER_SYMBOL, defender_strategy);
+  game->number_defenders = number_defenders;
+
+  spy_on_team(game->attackers, number_attackers,
+              game->defenders, number_defenders);
+  spy_on_team(game->defenders, number_defenders,
+              game->attackers, number_attackers);
+
+  game->number_captures = 0;
+  game->defender_positions = new_spatial_hash(number_defenders);
+  game->render_mode = RENDER_FULL;
+
+  return game;
+}
+
+/*----------------------------------------------------------------------------*/
+
+team_player_t* new_team(size_t number_players,
+                        char symbol,
+                        contextual_strategy_t strategy) {
+  team_player_t* team = malloc(number_players * sizeof(*team));
+
+  for (size_t k = 0; k < number_players; k++) {
+    team[k].item = new_item(symbol, true);
+    team[k].opponent_spy = NULL;
+    team[k].context = strategy.new_context != NULL
+      ? strategy.new_context(strategy.parameters)
+      : NULL;
+    team[k].is_captured = false;
+  }
+
+  return team;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void spy_on_team(team_player_t* team,
+                 size_t number_players,
+                 team_player_t* opponents,
+                 size_t number_opponents) {
+  for (size_t k = 0; k < number_players; k++) {
+    team[k].opponent_spy = new_spy(opponents[k % number_opponents].item);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void delete_team(team_player_t* team,
+                 size_t number_players,
+                 contextual_strategy_t strategy) {
+  for (size_t k = 0; k < number_players; k++) {
+    if (strategy.delete_context != NULL) {
+      strategy.delete_context(team[k].context);
+    }
+    delete_spy(team[k].opponent_spy);
+    delete_item(team[k].item);
+  }
+
+  free(team);
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool can_team_fit_in_field(dimension_t field_dimension,
+                           size_t number_players) {
+  size_t height = field_dimension.height;
+  if (number_players == 0 || number_players > height - 2) return false;
+
+  return get_team_player_row(0, number_players, height) >= 1
+    && get_team_player_row(number_players-1, number_players, height)
+      <= height - 2;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Players are centered in equal slices of the column, so a single
+// player starts in the middle, as in a Game
+size_t get_team_player_row(size_t player,
+                           size_t number_players,
+                           size_t field_height) {
+  return (2*player + 1) * field_height / (2*number_players);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_team_in_field(Field field,
+                       team_player_t* team,
+                       size_t number_players,
+                       size_t column) {
+  size_t height = get_field_dimension(field).height;
+
+  for (size_t k = 0; k < number_players; k++) {
+    position_t position = {
+      get_team_player_row(k, number_players, height), column
+    };
+    add_item_to_field(field, team[k].item, position);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void set_teams_in_field_from_map(TeamGame game, Map map) {
+  dimension_t map_dimension = get_map_dimension(map);
+
+  size_t attacker = 0;
+  size_t defender = 0;
+
+  for (size_t i = 0; i < map_dimension.height; i++) {
+    for (size_t j = 0; j < map_dimension.width; j++) {
+      position_t position = { i, j };
+
+      switch (get_map_symbol(map, position)) {
+        case ATTACKER_SYMBOL:
+          add_item_to_field(game->field, game->attackers[attacker++].item,
+                            position);
+          break;
+        case DEFENDER_SYMBOL:
+          add_item_to_field(game->field, game->defenders[defender++].item,
+                            position);
+          break;
+        case OBSTACLE_SYMBOL:
+          add_item_to_field(game->field, game->obstacle, position);
+          break;
+      }
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void index_defender_positions(TeamGame game) {
+  for (size_t k = 0; k < game->number_defenders; k++) {
+    insert_into_spatial_hash(game->defender_positions, k,
+                             get_item_position(game->defenders[k].item));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_result_t run_team_game(TeamGame game,
+                            size_t max_turns,
+                            Renderer renderer) {
+  if (renderer != NULL) render_field(renderer, game->field, 0);
+
+  game_result_t result;
+  for (size_t turn = 0; turn < max_turns; turn++) {
+    move_team(game->field, game->attackers, game->number_attackers,
+              game->attacker_strategy);
+    move_team(game->field, game->defenders, game->number_defenders,
+              game->defender_strategy);
+
+    // Defenders are indexed again only once all of them moved
+    index_defender_positions(game);
+
+    bool is_over = is_team_game_over(game, &result);
+    if (renderer != NULL) render_field(renderer, game->field, turn+1);
+
+    if (is_over) {
+      result.turns = turn+1;
+      return result;
+    }
+  }
+
+  // A draw happens only if no team wins before max_turns
+  return make_team_game_result(game, WINNER_NONE, REASON_DRAW, max_turns);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// The field keeps players from moving into occupied cells
+void move_team(Field field,
+               team_player_t* team,
+               size_t number_players,
+               contextual_strategy_t strategy) {
+  for (size_t k = 0; k < number_players; k++) {
+    team_player_t* player = &team[k];
+    if (player->is_captured) continue;
+
+    direction_t direction = strategy.execute(
+        player->context, get_item_position(player->item),
+        player->opponent_spy);
+
+    move_item_in_field(field, player->item, direction);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Same order as is_game_over(): cheating, then the goal, then captures
+bool is_team_game_over(TeamGame game, game_result_t* result) {
+  if (has_team_cheated(game->attackers, game->number_attackers,
+                       game->max_number_spies)) {
+    *result = make_team_game_result(game, WINNER_DEFENDER, REASON_CHEATING, 0);
+    return true;
+  }
+
+  if (has_team_cheated(game->defenders, game->number_defenders,
+                       game->max_number_spies)) {
+    *result = make_team_game_result(game, WINNER_ATTACKER, REASON_CHEATING, 0);
+    return true;
+  }
+
+  size_t goal_column = get_field_dimension(game->field).width - 2;
+  for (size_t k = 0; k < game->number_attackers; k++) {
+    team_player_t* attacker = &game->attackers[k];
+    if (attacker->is_captured) continue;
+
+    if (get_item_position(attacker->item).j == goal_column) {
+      *result = make_team_game_result(game, WINNER_ATTACKER, REASON_GOAL, 0);
+      return true;
+    }
+  }
+
+  capture_attackers(game);
+
+  if (game->number_captures == game->number_attackers) {
+    *result = make_team_game_result(game, WINNER_DEFENDER, REASON_CAPTURE, 0);
+    return true;
+  }
+
+  return false;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Each attacker looks for a defender only in the buckets around it
+void capture_attackers(TeamGame game) {
+  for (size_t k = 0; k < game->number_attackers; k++) {
+    team_player_t* attacker = &game->attackers[k];
+    if (attacker->is_captured) continue;
+
+    size_t defender;
+    size_t number_found = query_spatial_hash(
+        game->defender_positions, get_item_position(attacker->item), 1,
+        &defender, 1);
+    if (number_found == 0) continue;
+
+    remove_item_from_field(game->field, attacker->item);
+    attacker->is_captured = true;
+    game->number_captures++;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool has_team_cheated(team_player_t* team,
+                      size_t number_players,
+                      size_t max_number_spies) {
+  for (size_t k = 0; k < number_players; k++) {
+    if (get_spy_number_uses(team[k].opponent_spy) > max_number_spies) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t count_team_spy_uses(team_player_t* team, size_t number_players) {
+  size_t spy_uses = 0;
+  for (size_t k = 0; k < number_players; k++) {
+    spy_uses += get_spy_number_uses(team[k].opponent_spy);
+  }
+
+  return spy_uses;
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_result_t make_team_game_result(TeamGame game,
+                                    Winner winner,
+                                    GameOverReason reason,
+                                    size_t turns) {
+  game_result_t result = {
+    .winner = winner,
+    .reason = reason,
+    .turns = turns,
+    .attacker_spy_uses
+      = count_team_spy_uses(game->attackers, game->number_attackers),
+    .defender_spy_uses
+      = count_team_spy_uses(game->defenders, game->number_defenders),
+    .attacker_timeouts = 0,
+    .defender_timeouts = 0,
+  };
+
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
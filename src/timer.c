@@ -0,0 +1,23 @@
+// Standard headers
+#include <stdint.h>
+#include <time.h>
+
+// Main header
+#include "timer.h"
+
+// Macros
+#define NANOSECONDS_PER_SECOND 1000000000ULL
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+uint64_t get_monotonic_time(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t) now.tv_sec * NANOSECONDS_PER_SECOND
+    + (uint64_t) now.tv_nsec;
+}
+
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,281 @@
+// Standard headers
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Internal headers
+#include "batch.h"
+#include "game.h"
+#include "histogram.h"
+#include "map.h"
+#include "random.h"
+#include "tablebase.h"
+#include "timer.h"
+
+// Main header
+#include "tournament.h"
+
+/*----------------------------------------------------------------------------*/
+/*                        PRIVATE STRUCT IMPLEMENTATION                       */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * A worker plays the games in the range [first_game, last_game)
+ * and keeps its own statistics, merged after all workers finish.
+ */
+struct worker {
+  const tournament_t* tournament;
+  size_t first_game;
+  size_t last_game;
+
+  statistics_t statistics;
+  bool has_failed;
+
+  // Only allocated if the tournament records latencies
+  Histogram attacker_latencies;
+  Histogram defender_latencies;
+};
+typedef struct worker worker_t;
+
+/*----------------------------------------------------------------------------*/
+/*                          PRIVATE FUNCTIONS HEADERS                         */
+/*----------------------------------------------------------------------------*/
+
+void* run_worker(void* worker);
+void play_worker_games(worker_t* worker);
+void play_worker_batches(worker_t* worker);
+GamePool new_tournament_game_pool(const tournament_t* tournament);
+void add_observed_result(void* statistics, Game game, game_result_t result);
+
+/*----------------------------------------------------------------------------*/
+/*                              PUBLIC FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+statistics_t play_tournament(tournament_t tournament,
+                             statistics_t* thread_statistics) {
+  statistics_t statistics = NULL_STATISTICS;
+
+  size_t number_threads = tournament.number_threads;
+  if (number_threads == 0) number_threads = 1;
+
+  worker_t* workers = malloc(number_threads * sizeof(*workers));
+  pthread_t* threads = malloc(number_threads * sizeof(*threads));
+  bool* has_thread = calloc(number_threads, sizeof(*has_thread));
+
+  // Games are split in contiguous ranges of (almost) the same size
+  for (size_t t = 0; t < number_threads; t++) {
+    workers[t].tournament = &tournament;
+    workers[t].first_game = t * tournament.number_games / number_threads;
+    workers[t].last_game = (t+1) * tournament.number_games / number_threads;
+    workers[t].statistics = (statistics_t) NULL_STATISTICS;
+    workers[t].has_failed = false;
+
+    bool is_recording_latencies = tournament.attacker_latencies != NULL
+      || tournament.defender_latencies != NULL;
+    workers[t].attacker_latencies
+      = is_recording_latencies ? new_histogram() : NULL;
+    workers[t].defender_latencies
+      = is_recording_latencies ? new_histogram() : NULL;
+  }
+
+  uint64_t start_time = get_monotonic_time();
+
+  // The current thread works as the first worker, and also as the
+  // workers whose threads could not be started
+  for (size_t t = 1; t < number_threads; t++) {
+    has_thread[t]
+      = pthread_create(&threads[t], NULL, run_worker, &workers[t]) == 0;
+    if (!has_thread[t]) run_worker(&workers[t]);
+  }
+  run_worker(&workers[0]);
+  for (size_t t = 1; t < number_threads; t++) {
+    if (has_thread[t]) pthread_join(threads[t], NULL);
+  }
+
+  bool has_failed = false;
+  for (size_t t = 0; t < number_threads; t++) {
+    merge_statistics(&statistics, workers[t].statistics);
+    if (thread_statistics != NULL) {
+      thread_statistics[t] = workers[t].statistics;
+    }
+    has_failed = has_failed || workers[t].has_failed;
+
+    merge_histograms(tournament.attacker_latencies,
+                     workers[t].attacker_latencies);
+    merge_histograms(tournament.defender_latencies,
+                     workers[t].defender_latencies);
+
+    delete_histogram(workers[t].attacker_latencies);
+    delete_histogram(workers[t].defender_latencies);
+  }
+
+  // Merging sums the time of every thread, but they ran simultaneously
+  statistics.elapsed_time = get_monotonic_time() - start_time;
+
+  free(has_thread);
+  free(threads);
+  free(workers);
+
+  if (has_failed) return (statistics_t) NULL_STATISTICS;
+
+  return statistics;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void add_result_to_statistics(statistics_t* statistics,
+                              game_result_t result) {
+  statistics->games++;
+  statistics->turns += result.turns;
+
+  if (result.reason == REASON_CHEATING) statistics->cheats++;
+  statistics->timeouts += result.attacker_timeouts + result.defender_timeouts;
+
+  switch (result.winner) {
+    case WINNER_ATTACKER: statistics->attacker_wins++; break;
+    case WINNER_DEFENDER: statistics->defender_wins++; break;
+    case WINNER_NONE: statistics->draws++; break;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+void merge_statistics(statistics_t* statistics, statistics_t other) {
+  statistics->games += other.games;
+  statistics->attacker_wins += other.attacker_wins;
+  statistics->defender_wins += other.defender_wins;
+  statistics->draws += other.draws;
+  statistics->cheats += other.cheats;
+  statistics->timeouts += other.timeouts;
+  statistics->turns += other.turns;
+  statistics->elapsed_time += other.elapsed_time;
+  merge_tablebase_scores(&statistics->score, other.score);
+}
+
+/*----------------------------------------------------------------------------*/
+
+game_observer_t make_statistics_observer(statistics_t* statistics) {
+  game_observer_t observer = {
+    .on_game_start = NULL,
+    .on_spy_use = NULL,
+    .on_turn_end = NULL,
+    .on_game_end = add_observed_result,
+    .data = statistics,
+  };
+
+  return observer;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             PRIVATE FUNCTIONS                              */
+/*----------------------------------------------------------------------------*/
+
+void* run_worker(void* worker) {
+  worker_t* self = worker;
+
+  uint64_t start_time = get_monotonic_time();
+
+  if (self->tournament->batch_size == 0) {
+    play_worker_games(self);
+  } else {
+    play_worker_batches(self);
+  }
+
+  self->statistics.elapsed_time = get_monotonic_time() - start_time;
+
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Each worker plays its games one at a time, reusing the same pooled
+// game, so no memory is allocated after the first one
+void play_worker_games(worker_t* self) {
+  GamePool pool = new_tournament_game_pool(self->tournament);
+
+  tablebase_oracle_t oracle = {
+    .tablebase = self->tournament->tablebase,
+    .score = NULL_TABLEBASE_SCORE,
+  };
+
+  for (size_t k = self->first_game; k < self->last_game; k++) {
+    Game game = acquire_pooled_game(pool);
+    if (game == NULL) {
+      self->has_failed = true;
+      break;
+    }
+
+    seed_game(game, mix_seed(self->tournament->seed, k));
+    set_game_deadline(game, self->tournament->deadline);
+    set_game_latency_histograms(game,
+                                self->attacker_latencies,
+                                self->defender_latencies);
+    if (oracle.tablebase != NULL) {
+      add_game_observer(game, make_tablebase_observer(&oracle));
+    }
+
+    game_result_t result
+      = play_game_quietly(game, self->tournament->max_turns);
+    add_result_to_statistics(&self->statistics, result);
+
+    release_pooled_game(pool, game);
+  }
+
+  self->statistics.score = oracle.score;
+  delete_game_pool(pool);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void play_worker_batches(worker_t* self) {
+  size_t batch_size = self->tournament->batch_size;
+
+  Batch batch = new_batch(*self->tournament, batch_size);
+  if (batch == NULL) {
+    self->has_failed = true;
+    return;
+  }
+
+  set_batch_latency_histograms(batch,
+                               self->attacker_latencies,
+                               self->defender_latencies);
+
+  game_result_t* results = malloc(batch_size * sizeof(*results));
+
+  for (size_t k = self->first_game; k < self->last_game; k += batch_size) {
+    size_t number_games = self->last_game - k < batch_size
+      ? self->last_game - k
+      : batch_size;
+
+    play_batch(batch, k, number_games, results);
+
+    for (size_t lane = 0; lane < number_games; lane++) {
+      add_result_to_statistics(&self->statistics, results[lane]);
+    }
+  }
+
+  free(results);
+  delete_batch(batch);
+}
+
+/*----------------------------------------------------------------------------*/
+
+GamePool new_tournament_game_pool(const tournament_t* tournament) {
+  return new_game_pool(
+      tournament->map,
+      tournament->field_dimension,
+      tournament->max_number_spies,
+      tournament->attacker_strategy,
+      tournament->defender_strategy);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void add_observed_result(void* statistics, Game game, game_result_t result) {
+  (void) game; // Only the result is needed
+
+  add_result_to_statistics(statistics, result);
+}
+
+/*----------------------------------------------------------------------------*/
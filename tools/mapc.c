@@ -0,0 +1,37 @@
+// Standard headers
+#include <stdio.h>
+#include <stdlib.h>
+
+// Internal headers
+#include "map.h"
+
+/*----------------------------------------------------------------------------*/
+/*                               MAIN FUNCTION                                */
+/*----------------------------------------------------------------------------*/
+
+// Compiles a text map into a binary map, which new_map loads without parsing
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "USAGE: %s map_path compiled_map_path\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  Map map = new_map(argv[1]);
+  if (map == NULL) return EXIT_FAILURE;
+
+  if (!write_compiled_map(map, argv[2])) {
+    delete_map(map);
+    return EXIT_FAILURE;
+  }
+
+  dimension_t dimension = get_map_dimension(map);
+  printf("%s: %lu x %lu, %lu obstacles, hash %016lx\n",
+      argv[2], dimension.height, dimension.width,
+      get_map_symbol_occurrences(map, 'X'), get_map_hash(map));
+
+  delete_map(map);
+
+  return EXIT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,57 @@
+// Standard headers
+#include <stdio.h>
+#include <stdlib.h>
+
+// Internal headers
+#include "map.h"
+#include "replay.h"
+#include "tablebase.h"
+
+/*----------------------------------------------------------------------------*/
+/*                               MAIN FUNCTION                                */
+/*----------------------------------------------------------------------------*/
+
+// Solves every state of a map and saves the tablebase, which main loads
+// with --oracle to score the moves of the strategies
+int main(int argc, char** argv) {
+  if (argc != 3 && argc != 4) {
+    fprintf(stderr, "USAGE: %s map_path tablebase_path [threads]\n",
+        argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  size_t number_threads = argc == 4 ? strtoul(argv[3], NULL, 10) : 1;
+
+  Map map = new_map(argv[1]);
+  if (map == NULL) return EXIT_FAILURE;
+
+  Tablebase tablebase = generate_tablebase(map, number_threads);
+  if (tablebase == NULL || !save_tablebase(tablebase, argv[2])) {
+    delete_tablebase(tablebase);
+    delete_map(map);
+    return EXIT_FAILURE;
+  }
+
+  position_t attacker = get_map_symbol_position(map, 'A');
+  position_t defender = get_map_symbol_position(map, 'D');
+  tablebase_entry_t start
+    = probe_tablebase(tablebase, attacker, defender, REPLAY_ATTACKER);
+
+  const char* outcomes[] = {
+    "draw", "attacker wins", "defender wins", "invalid",
+  };
+
+  dimension_t dimension = get_tablebase_dimension(tablebase);
+  printf("%s: %lu x %lu, hash %016lx, longest win in %lu moves\n",
+      argv[2], dimension.height, dimension.width,
+      get_tablebase_map_hash(tablebase),
+      get_tablebase_max_distance(tablebase));
+  printf("Start: %s in %lu moves\n", outcomes[start.outcome], start.distance);
+
+  delete_tablebase(tablebase);
+  delete_map(map);
+
+  return EXIT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/